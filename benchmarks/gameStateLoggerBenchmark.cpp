@@ -0,0 +1,90 @@
+// Benchmark of the cost of logging events in the game state log.
+// Usage: gameStateLoggerBenchmark [events per interval] [intervals]
+//
+// Measures the two parts of an event: queueing it on the main thread when it happens (GameStateLogger::logEvent),
+// and serializing all queued events at the next logging interval (GameStateLogger::logEvents).
+// The entries are written with the same fields as GameStateLogger::writeEventEntry.
+#include "jsonGenerator.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+class Event
+{
+public:
+    int type;
+    float time;
+    int source_id;
+    int target_id;
+    float x, y;
+    float value;
+};
+
+static const char* event_names[] = {"beam_fire", "missile_launch", "damage", "destroyed", "docked", "scanned"};
+
+static void writeEventEntry(char*& ptr, const Event& event)
+{
+    JSONGenerator json(ptr);
+    json.write("type", "event");
+    json.write("time", event.time);
+    json.write("event", event_names[event.type]);
+    json.write("source", event.source_id);
+    if (event.target_id > -1)
+        json.write("target", event.target_id);
+    json.startArray("position");
+    json.arrayWrite(event.x);
+    json.arrayWrite(event.y);
+    json.endArray();
+    json.write("value", event.value);
+}
+
+int main(int argc, char** argv)
+{
+    int events_per_interval = argc > 1 ? atoi(argv[1]) : 1000;
+    int intervals = argc > 2 ? atoi(argv[2]) : 100;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-100000.0f, 100000.0f);
+    std::uniform_int_distribution<int> type(0, 5);
+    std::uniform_int_distribution<int> id(-1, 1000);
+    std::vector<Event> source;
+    for(int n=0; n<events_per_interval; n++)
+        source.push_back({type(rng), float(n) * 0.001f, id(rng) + 1, id(rng), coordinate(rng), coordinate(rng), coordinate(rng) * 0.001f});
+
+    std::vector<Event> events;
+    std::vector<char> output;
+    char buffer[1024];
+    double queue_ns = 0.0;
+    double write_ns = 0.0;
+    size_t bytes = 0;
+    for(int interval=0; interval<intervals; interval++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for(const Event& event : source)
+            events.push_back(event);
+        auto queued = std::chrono::steady_clock::now();
+        for(const Event& event : events)
+        {
+            char* ptr = buffer;
+            writeEventEntry(ptr, event);
+            *ptr++ = '\n';
+            output.insert(output.end(), buffer, ptr);
+        }
+        events.clear();
+        auto written = std::chrono::steady_clock::now();
+
+        queue_ns += std::chrono::duration<double, std::nano>(queued - start).count();
+        write_ns += std::chrono::duration<double, std::nano>(written - queued).count();
+        bytes += output.size();
+        output.clear();
+    }
+
+    double total = double(events_per_interval) * intervals;
+    printf("%d events per interval, %d intervals\n", events_per_interval, intervals);
+    printf("queue: %8.1f ns per event\n", queue_ns / total);
+    printf("write: %8.1f ns per event, %.1f bytes per event\n", write_ns / total, bytes / total);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Stress test of the HardwareChannelBuffer triple buffer between the main thread and an output device thread.
+// Usage: hardwareChannelBufferStress [channels] [frames per second] [seconds]
+//
+// The producer sets every channel of frame F to the value F and publishes it, at the given rate.
+// The consumer fetches as fast as it can and checks that every fetched frame is complete (all channels hold the same frame)
+// and that frames never go backwards or repeat. Any violation fails the test.
+#include "hardware/hardwareChannelBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char** argv)
+{
+    int channel_count = argc > 1 ? atoi(argv[1]) : 512;
+    int rate = argc > 2 ? atoi(argv[2]) : 1000;
+    float seconds = argc > 3 ? float(atof(argv[3])) : 5.0f;
+    int frame_count = int(rate * seconds);
+
+    HardwareChannelBuffer buffer;
+    buffer.resize(channel_count);
+
+    std::atomic<bool> running{true};
+    int fetched = 0;
+    int torn = 0;
+    int out_of_order = 0;
+    std::thread consumer([&]()
+    {
+        float last_frame = 0.0f;
+        while(running.load())
+        {
+            if (!buffer.fetch())
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            fetched++;
+            const std::vector<float>& frame = buffer.getFrame();
+            for(int n=1; n<channel_count; n++)
+            {
+                if (frame[n] != frame[0])
+                {
+                    torn++;
+                    break;
+                }
+            }
+            if (frame[0] <= last_frame)
+                out_of_order++;
+            last_frame = frame[0];
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    double producer_ns = 0.0;
+    for(int frame=1; frame<=frame_count; frame++)
+    {
+        auto produce_start = std::chrono::steady_clock::now();
+        for(int n=0; n<channel_count; n++)
+            buffer.setChannel(n, float(frame));
+        buffer.publish();
+        producer_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - produce_start).count();
+
+        next += std::chrono::nanoseconds(1000000000 / rate);
+        std::this_thread::sleep_until(next);
+    }
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+    consumer.join();
+
+    printf("%d channels, %d frames published in %.2f seconds\n", channel_count, frame_count, elapsed);
+    printf("producer: %.1f ns per frame (set all channels and publish)\n", producer_ns / frame_count);
+    printf("consumer: %d frames fetched\n", fetched);
+    printf("torn frames: %d, out of order or repeated frames: %d\n", torn, out_of_order);
+    if (torn > 0 || out_of_order > 0)
+    {
+        printf("ERROR: the consumer saw inconsistent frames\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Benchmark of the path planner avoid object grid: N route segments queried through M obstacles.
+// Usage: pathPlannerBenchmark [segments] [obstacles] [seed]
+//
+// Every query is also answered with a linear scan over all obstacles. The grid only visits the sectors on the line of the
+// segment, so small obstacles that reach the segment from a neighbouring sector are not seen, just like the path planner
+// always did. The agreement between both is reported, the grid should never find an obstacle the linear scan does not.
+#include "avoidObjectGrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool linearQuery(const std::vector<glm::vec2>& positions, const std::vector<float>& sizes, glm::vec2 start, glm::vec2 end, float margin, uint32_t& index)
+{
+    glm::vec2 diff = end - start;
+    float length = glm::length(diff);
+    glm::vec2 direction = diff / length;
+    float first_f = length;
+    bool found = false;
+    for(uint32_t n=0; n<positions.size(); n++)
+    {
+        float f = glm::dot(direction, positions[n] - start);
+        if (f > 0 && f < length - sizes[n] && f < first_f)
+        {
+            glm::vec2 q = start + direction * f;
+            if (glm::length2(q - positions[n]) < (sizes[n] + margin) * (sizes[n] + margin))
+            {
+                first_f = f;
+                index = n;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+int main(int argc, char** argv)
+{
+    int segment_count = argc > 1 ? atoi(argv[1]) : 10000;
+    int obstacle_count = argc > 2 ? atoi(argv[2]) : 2000;
+    unsigned int seed = argc > 3 ? atoi(argv[3]) : 1;
+    const float area = 100000.0f;
+    const float margin = 300.0f;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coordinate(-area, area);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Mostly small obstacles like asteroids and mines, with a few big ones like planets and black holes.
+    AvoidObjectGrid grid;
+    std::vector<glm::vec2> positions;
+    std::vector<float> sizes;
+    for(int n=0; n<obstacle_count; n++)
+    {
+        glm::vec2 position(coordinate(rng), coordinate(rng));
+        float size = unit(rng) < 0.05f ? 1000.0f + unit(rng) * 4000.0f : 100.0f + unit(rng) * 500.0f;
+        grid.add(position, size);
+        positions.push_back(position);
+        sizes.push_back(size);
+    }
+
+    std::vector<glm::vec2> starts;
+    std::vector<glm::vec2> ends;
+    for(int n=0; n<segment_count; n++)
+    {
+        glm::vec2 start(coordinate(rng), coordinate(rng));
+        float angle = unit(rng) * 6.2831853f;
+        float length = 5000.0f + unit(rng) * 45000.0f;
+        starts.push_back(start);
+        ends.push_back(start + glm::vec2(std::cos(angle), std::sin(angle)) * length);
+    }
+
+    auto time_start = std::chrono::steady_clock::now();
+    std::vector<int> grid_results(segment_count, -1);
+    for(int n=0; n<segment_count; n++)
+    {
+        AvoidObjectGrid::Result result;
+        if (grid.querySegment(starts[n], ends[n], margin, result))
+            grid_results[n] = result.index;
+    }
+    auto time_grid = std::chrono::steady_clock::now();
+    std::vector<int> linear_results(segment_count, -1);
+    for(int n=0; n<segment_count; n++)
+    {
+        uint32_t index;
+        if (linearQuery(positions, sizes, starts[n], ends[n], margin, index))
+            linear_results[n] = index;
+    }
+    auto time_linear = std::chrono::steady_clock::now();
+
+    // Move every obstacle a bit, as PathPlannerManager::update does every frame.
+    for(int n=0; n<obstacle_count; n++)
+        positions[n] += glm::vec2(unit(rng) - 0.5f, unit(rng) - 0.5f) * 2000.0f;
+    auto time_update_start = std::chrono::steady_clock::now();
+    for(int n=0; n<obstacle_count; n++)
+        grid.setPosition(n, positions[n]);
+    auto time_update = std::chrono::steady_clock::now();
+
+    int agree = 0;
+    int wrong = 0;
+    for(int n=0; n<segment_count; n++)
+    {
+        if (grid_results[n] == linear_results[n])
+            agree++;
+        else if (grid_results[n] >= 0 && linear_results[n] < 0)
+            wrong++;
+    }
+
+    auto ns_per = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b, int count)
+    {
+        return std::chrono::duration<double, std::nano>(b - a).count() / std::max(count, 1);
+    };
+    printf("%d segments through %d obstacles\n", segment_count, obstacle_count);
+    printf("grid:   %10.1f ns per query\n", ns_per(time_start, time_grid, segment_count));
+    printf("linear: %10.1f ns per query\n", ns_per(time_grid, time_linear, segment_count));
+    printf("update: %10.1f ns per obstacle\n", ns_per(time_update_start, time_update, obstacle_count));
+    printf("agreement with linear scan: %d of %d\n", agree, segment_count);
+    if (wrong > 0)
+    {
+        printf("ERROR: grid found %d obstacles the linear scan did not\n", wrong);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,271 @@
+// Benchmark of the per frame shield and system updates of ships: per object updates against a single batched pass.
+// Usage: shipSystemsBenchmark [ships] [frames]
+//
+// The per object update is the loop each ship runs in ShipTemplateBasedObject::update, SpaceShip::update and
+// CpuShip::update, reached through a virtual call on an object that is allocated on its own, like the game objects.
+// The batched pass gathers the values of all ships into flat arrays, runs loops the compiler can vectorize, and scatters
+// the results back. The values have to stay on the objects, as they are replicated by address.
+// The values of both are compared afterwards, the batch has to give the same results.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr int max_shield_count = 8;
+static constexpr int system_count = 8;
+
+// Same layout as ShipSystem in spaceship.h.
+class System
+{
+public:
+    float health, health_max, power_level, power_request, heat_level, coolant_level, coolant_request, hacked_level, power_factor;
+    float coolant_rate_per_second, heat_rate_per_second, power_rate_per_second;
+};
+
+class ShipSystemsBatch
+{
+public:
+    class Entry
+    {
+    public:
+        const int* shield_count = nullptr;
+        float* shield_level = nullptr;
+        float* shield_max = nullptr;
+        float* shield_hit_effect = nullptr;
+        const float* shield_recharge_rate = nullptr;
+        // System values are members of an array of structs, so they are system_stride floats apart.
+        int system_count = 0;
+        int system_stride = 0;
+        float* system_health = nullptr;
+        const float* system_health_max = nullptr;
+        float* system_hacked_level = nullptr;
+        float unhack_per_second = 0.0f;
+        float repair_per_second = 0.0f;
+    };
+
+    std::vector<Entry*> entries;
+
+    void update(float delta)
+    {
+        size_t shield_total = 0;
+        size_t system_total = 0;
+        for(Entry* entry : entries)
+        {
+            shield_total += *entry->shield_count;
+            system_total += entry->system_count;
+        }
+        shield_level.resize(shield_total);
+        shield_max.resize(shield_total);
+        shield_hit_effect.resize(shield_total);
+        shield_recharge_rate.resize(shield_total);
+        system_health.resize(system_total);
+        system_health_max.resize(system_total);
+        system_hacked_level.resize(system_total);
+        system_unhack.resize(system_total);
+        system_repair.resize(system_total);
+
+        size_t s = 0;
+        size_t y = 0;
+        for(Entry* entry : entries)
+        {
+            for(int n=0; n<*entry->shield_count; n++, s++)
+            {
+                shield_level[s] = entry->shield_level[n];
+                shield_max[s] = entry->shield_max[n];
+                shield_hit_effect[s] = entry->shield_hit_effect[n];
+                shield_recharge_rate[s] = entry->shield_recharge_rate[n];
+            }
+            for(int n=0; n<entry->system_count; n++, y++)
+            {
+                system_health[y] = entry->system_health[n * entry->system_stride];
+                system_health_max[y] = entry->system_health_max[n * entry->system_stride];
+                system_hacked_level[y] = entry->system_hacked_level[n * entry->system_stride];
+                system_unhack[y] = entry->unhack_per_second;
+                system_repair[y] = entry->repair_per_second;
+            }
+        }
+
+        float* level = shield_level.data();
+        const float* level_max = shield_max.data();
+        float* hit_effect = shield_hit_effect.data();
+        const float* rate = shield_recharge_rate.data();
+        for(size_t n=0; n<shield_total; n++)
+        {
+            level[n] = std::max(level[n], std::min(level_max[n], level[n] + delta * rate[n]));
+            hit_effect[n] = hit_effect[n] > 0.0f ? hit_effect[n] - delta : hit_effect[n];
+        }
+
+        float* health = system_health.data();
+        const float* health_max = system_health_max.data();
+        float* hacked_level = system_hacked_level.data();
+        const float* unhack = system_unhack.data();
+        const float* repair = system_repair.data();
+        for(size_t n=0; n<system_total; n++)
+        {
+            hacked_level[n] = std::max(0.0f, hacked_level[n] - delta * unhack[n]);
+            health[n] = std::min(health[n], health_max[n]);
+            health[n] = repair[n] > 0.0f ? std::min(1.0f, health[n] + delta * repair[n]) : health[n];
+        }
+
+        s = 0;
+        y = 0;
+        for(Entry* entry : entries)
+        {
+            for(int n=0; n<*entry->shield_count; n++, s++)
+            {
+                entry->shield_level[n] = shield_level[s];
+                entry->shield_hit_effect[n] = shield_hit_effect[s];
+            }
+            for(int n=0; n<entry->system_count; n++, y++)
+            {
+                entry->system_health[n * entry->system_stride] = system_health[y];
+                entry->system_hacked_level[n * entry->system_stride] = system_hacked_level[y];
+            }
+        }
+    }
+private:
+    std::vector<float> shield_level;
+    std::vector<float> shield_max;
+    std::vector<float> shield_hit_effect;
+    std::vector<float> shield_recharge_rate;
+    std::vector<float> system_health;
+    std::vector<float> system_health_max;
+    std::vector<float> system_hacked_level;
+    std::vector<float> system_unhack;
+    std::vector<float> system_repair;
+};
+
+class Ship
+{
+public:
+    int shield_count;
+    float shield_level[max_shield_count];
+    float shield_max[max_shield_count];
+    float shield_hit_effect[max_shield_count];
+    float shield_recharge_rate[max_shield_count];
+    System systems[system_count];
+    float unhack_per_second;
+    float repair_per_second;
+    // The rest of a ship, which the per object update drags through the cache. A CpuShip is several kilobytes.
+    char other_members[4096];
+    ShipSystemsBatch::Entry entry;
+
+    virtual ~Ship() {}
+    virtual void update(float delta)
+    {
+        for(int n=0; n<shield_count; n++)
+        {
+            shield_level[n] = std::max(shield_level[n], std::min(shield_max[n], shield_level[n] + delta * shield_recharge_rate[n]));
+            shield_hit_effect[n] = shield_hit_effect[n] > 0.0f ? shield_hit_effect[n] - delta : shield_hit_effect[n];
+        }
+        const float unhack = delta * unhack_per_second;
+        for(int n=0; n<system_count; n++)
+        {
+            systems[n].hacked_level = std::max(0.0f, systems[n].hacked_level - unhack);
+            systems[n].health = std::min(systems[n].health, systems[n].health_max);
+        }
+        if (repair_per_second > 0.0f)
+        {
+            const float repair = delta * repair_per_second;
+            for(int n=0; n<system_count; n++)
+                systems[n].health = std::min(1.0f, systems[n].health + repair);
+        }
+    }
+};
+
+static std::vector<std::unique_ptr<Ship>> createShips(int ship_count)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::unique_ptr<Ship>> ships;
+    for(int n=0; n<ship_count; n++)
+    {
+        std::unique_ptr<Ship> ship(new Ship());
+        // Mostly ships with 1 or 2 shields, some stations and big ships with more.
+        ship->shield_count = n % 10 == 0 ? 4 + (n / 10) % 5 : 1 + n % 2;
+        for(int s=0; s<max_shield_count; s++)
+        {
+            ship->shield_max[s] = 50.0f + unit(rng) * 200.0f;
+            ship->shield_level[s] = ship->shield_max[s] * unit(rng);
+            ship->shield_hit_effect[s] = unit(rng) < 0.2f ? unit(rng) : 0.0f;
+            ship->shield_recharge_rate[s] = 0.3f * unit(rng);
+        }
+        for(int s=0; s<system_count; s++)
+        {
+            ship->systems[s] = {};
+            ship->systems[s].health_max = 0.5f + unit(rng) * 0.5f;
+            ship->systems[s].health = unit(rng);
+            ship->systems[s].hacked_level = unit(rng) < 0.1f ? unit(rng) : 0.0f;
+        }
+        ship->unhack_per_second = 1.0f / 180.0f;
+        ship->repair_per_second = n % 4 == 0 ? 0.0f : 0.005f;
+
+        ship->entry.shield_count = &ship->shield_count;
+        ship->entry.shield_level = ship->shield_level;
+        ship->entry.shield_max = ship->shield_max;
+        ship->entry.shield_hit_effect = ship->shield_hit_effect;
+        ship->entry.shield_recharge_rate = ship->shield_recharge_rate;
+        ship->entry.system_count = system_count;
+        ship->entry.system_stride = sizeof(System) / sizeof(float);
+        ship->entry.system_health = &ship->systems[0].health;
+        ship->entry.system_health_max = &ship->systems[0].health_max;
+        ship->entry.system_hacked_level = &ship->systems[0].hacked_level;
+        ship->entry.unhack_per_second = ship->unhack_per_second;
+        ship->entry.repair_per_second = ship->repair_per_second;
+        ships.push_back(std::move(ship));
+    }
+    return ships;
+}
+
+int main(int argc, char** argv)
+{
+    int ship_count = argc > 1 ? atoi(argv[1]) : 2000;
+    int frame_count = argc > 2 ? atoi(argv[2]) : 1000;
+    const float delta = 1.0f / 60.0f;
+
+    std::vector<std::unique_ptr<Ship>> object_ships = createShips(ship_count);
+    std::vector<std::unique_ptr<Ship>> batch_ships = createShips(ship_count);
+    ShipSystemsBatch batch;
+    for(auto& ship : batch_ships)
+        batch.entries.push_back(&ship->entry);
+
+    auto time_start = std::chrono::steady_clock::now();
+    for(int frame=0; frame<frame_count; frame++)
+        for(auto& ship : object_ships)
+            ship->update(delta);
+    auto time_object = std::chrono::steady_clock::now();
+    for(int frame=0; frame<frame_count; frame++)
+        batch.update(delta);
+    auto time_batch = std::chrono::steady_clock::now();
+
+    // Allow for rounding differences, the compiler may fuse the multiply and add in one loop but not in the other.
+    auto differs = [](float a, float b) { return std::abs(a - b) > 1e-4f; };
+    int mismatch = 0;
+    for(int n=0; n<ship_count; n++)
+    {
+        Ship& a = *object_ships[n];
+        Ship& b = *batch_ships[n];
+        for(int s=0; s<a.shield_count; s++)
+            if (differs(a.shield_level[s], b.shield_level[s]) || differs(a.shield_hit_effect[s], b.shield_hit_effect[s]))
+                mismatch++;
+        for(int s=0; s<system_count; s++)
+            if (differs(a.systems[s].health, b.systems[s].health) || differs(a.systems[s].hacked_level, b.systems[s].hacked_level))
+                mismatch++;
+    }
+
+    double object_us = std::chrono::duration<double, std::micro>(time_object - time_start).count() / frame_count;
+    double batch_us = std::chrono::duration<double, std::micro>(time_batch - time_object).count() / frame_count;
+    printf("%d ships, %d frames\n", ship_count, frame_count);
+    printf("per object: %8.2f us per frame\n", object_us);
+    printf("batch:      %8.2f us per frame\n", batch_us);
+    if (mismatch > 0)
+    {
+        printf("ERROR: %d values differ between the per object update and the batch\n", mismatch);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+# python3 script to convert a binary game state log (game_logs_format=binary) back to json lines.
+#
+# The output is identical to the log written with the default json format,
+# so it can be used with the log viewer in logs/index.html and other existing tools.
+#
+# Usage: python3 game_log_convert.py logs/game_log_<date>.bin [output.txt]
+# When no output file is given, the json lines are written to stdout.
+
+import struct
+import sys
+
+
+class RecordReader(object):
+    def __init__(self, data):
+        self.data = data
+        self.offset = 0
+
+    def byte(self):
+        value = self.data[self.offset]
+        self.offset += 1
+        return value
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.byte()
+            value |= (b & 0x7f) << shift
+            shift += 7
+            if b < 0x80:
+                return value
+
+    def bytes(self, size):
+        value = self.data[self.offset:self.offset + size]
+        self.offset += size
+        return value
+
+    def string(self):
+        return self.bytes(self.varint())
+
+
+def readEntry(reader, base_entries):
+    object_id = reader.varint()
+    mode = reader.byte()
+    if mode == 0:
+        entry = reader.string()
+        base_entries[object_id] = entry
+        return entry
+    base = base_entries[object_id]
+    if mode == 2:
+        return base
+    token_count = reader.varint()
+    mask = reader.bytes((token_count + 7) // 8)
+    tokens = base.split(b",")
+    for n in range(token_count):
+        if mask[n // 8] & (1 << (n % 8)):
+            tokens[n] = reader.string()
+    return b",".join(tokens)
+
+
+def convert(input_file, output):
+    data = input_file.read()
+    if data[:5] != b"EEGL\x01":
+        raise ValueError("Not a binary game state log")
+    offset = 5
+    base_entries = {}
+    while offset + 4 <= len(data):
+        size, = struct.unpack_from("<I", data, offset)
+        offset += 4
+        reader = RecordReader(data[offset:offset + size])
+        offset += size
+
+        record_type = reader.byte()
+        if record_type == ord("E"):
+            for n in range(reader.varint()):
+                output.write(reader.string() + b"\n")
+            continue
+        time = reader.string()
+        new_static = [readEntry(reader, base_entries) for n in range(reader.varint())]
+        del_static = [reader.varint() for n in range(reader.varint())]
+        objects = [readEntry(reader, base_entries) for n in range(reader.varint())]
+        if record_type == ord("K"):
+            # Full entries of the known static objects, only needed when seeking to this keyframe.
+            for n in range(reader.varint()):
+                readEntry(reader, base_entries)
+        for object_id in del_static:
+            base_entries.pop(object_id, None)
+
+        line = b'{"type":"state","time":' + time
+        line += b',"new_static":[' + b",".join(new_static) + b"]"
+        line += b',"del_static":[' + b",".join(str(object_id).encode() for object_id in del_static) + b"]"
+        line += b',"objects":[' + b",".join(objects) + b"]}\n"
+        output.write(line)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Usage: %s <binary log> [output.txt]" % (sys.argv[0]))
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as input_file:
+        if len(sys.argv) > 2:
+            with open(sys.argv[2], "wb") as output:
+                convert(input_file, output)
+        else:
+            convert(input_file, sys.stdout.buffer)
@@ -237,7 +237,7 @@ void ShipAI::updateTarget()
     long_range = owner->getLongRangeRadarRange();
 
     // Check if we lost our target because it entered a nebula.
-    if (target && target->canHideInNebula() && Nebula::blockedByNebula(position, target->getPosition(), owner->getShortRangeRadarRange()))
+    if (target && target->canHideInNebula() && Nebula::blockedByNebula(owner, target, owner->getShortRangeRadarRange()))
     {
         // When we're roaming, and we lost our target in a nebula, set the
         // "fly to" position to the last known position of the enemy target.
@@ -658,13 +658,12 @@ P<SpaceObject> ShipAI::findBestTarget(glm::vec2 position, float radius)
     float target_score = 0.0;
     PVector<Collisionable> objectList = CollisionManager::queryArea(position - glm::vec2(radius, radius), position + glm::vec2(radius, radius));
     P<SpaceObject> target;
-    auto owner_position = owner->getPosition();
     foreach(Collisionable, obj, objectList)
     {
         P<SpaceObject> space_object = obj;
         if (!space_object || !space_object->canBeTargetedBy(owner) || !owner->isEnemy(space_object) || space_object == target)
             continue;
-        if (space_object->canHideInNebula() && Nebula::blockedByNebula(owner_position, space_object->getPosition(), owner->getShortRangeRadarRange()))
+        if (space_object->canHideInNebula() && Nebula::blockedByNebula(owner, space_object, owner->getShortRangeRadarRange()))
             continue;
         float score = targetScore(space_object);
         if (score == std::numeric_limits<float>::min())
@@ -87,7 +87,7 @@ bool EvasionAI::evadeIfNecessary()
         P<SpaceShip> ship = obj;
         if (!ship || !owner->isEnemy(ship))
             continue;
-        if (ship->canHideInNebula() && Nebula::blockedByNebula(position, ship->getPosition(), owner->getShortRangeRadarRange()))
+        if (ship->canHideInNebula() && Nebula::blockedByNebula(owner, ship, owner->getShortRangeRadarRange()))
             continue;
         float score = evasionDangerScore(ship, scan_radius);
         if (score == std::numeric_limits<float>::min())
@@ -0,0 +1,80 @@
+#include "avoidObjectGrid.h"
+#include <algorithm>
+#include <cmath>
+
+
+int32_t AvoidObjectGrid::positionToSector(float f)
+{
+    return static_cast<int32_t>(std::lrint(f / sector_size));
+}
+
+void AvoidObjectGrid::add(glm::vec2 position, float size)
+{
+    uint32_t index = positions.size();
+    positions.push_back(position);
+    sizes.push_back(size);
+    if (size < small_object_max_size)
+    {
+        uint64_t key = positionKey(position);
+        sector_keys.push_back(key);
+        sectors[key].push_back(index);
+    }else{
+        sector_keys.push_back(big_object_key);
+        big_objects.push_back(index);
+    }
+}
+
+void AvoidObjectGrid::removeFromSector(uint64_t key, uint32_t index)
+{
+    auto it = sectors.find(key);
+    it->second.erase(std::find(it->second.begin(), it->second.end(), index));
+    if (it->second.empty())
+        sectors.erase(it);
+}
+
+void AvoidObjectGrid::replaceIndex(uint32_t old_index, uint32_t new_index)
+{
+    std::vector<uint32_t>& list = sector_keys[old_index] == big_object_key ? big_objects : sectors[sector_keys[old_index]];
+    for(auto& idx : list)
+    {
+        if (idx == old_index)
+        {
+            idx = new_index;
+            return;
+        }
+    }
+}
+
+void AvoidObjectGrid::remove(uint32_t index)
+{
+    if (sector_keys[index] == big_object_key)
+        big_objects.erase(std::find(big_objects.begin(), big_objects.end(), index));
+    else
+        removeFromSector(sector_keys[index], index);
+
+    uint32_t last = positions.size() - 1;
+    if (index != last)
+    {
+        replaceIndex(last, index);
+        positions[index] = positions[last];
+        sizes[index] = sizes[last];
+        sector_keys[index] = sector_keys[last];
+    }
+    positions.pop_back();
+    sizes.pop_back();
+    sector_keys.pop_back();
+}
+
+void AvoidObjectGrid::setPosition(uint32_t index, glm::vec2 position)
+{
+    positions[index] = position;
+    if (sector_keys[index] == big_object_key)
+        return;
+    uint64_t key = positionKey(position);
+    if (key != sector_keys[index])
+    {
+        removeFromSector(sector_keys[index], index);
+        sector_keys[index] = key;
+        sectors[key].push_back(index);
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef AVOID_OBJECT_GRID_H
+#define AVOID_OBJECT_GRID_H
+
+#include <glm/vec2.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtx/norm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utility>
+
+// Circular objects to avoid, stored in flat arrays indexed by the same slot.
+// Small objects are bucketed in a sector grid so queries only need to visit the sectors a segment crosses,
+// big objects are kept in a separate index list that is checked for every query.
+// This has no dependencies on the engine, so it can be benchmarked on its own, see benchmarks/pathPlannerBenchmark.cpp.
+class AvoidObjectGrid
+{
+public:
+    class Result
+    {
+    public:
+        uint32_t index = 0;     // Slot of the object to avoid
+        glm::vec2 position{};   // Position of the object to avoid
+        float size = 0.0f;      // Avoidance radius of the object
+        glm::vec2 closest{};    // Closest point on the segment to the object
+    };
+
+    // Add an object, it is stored in the slot size() - 1.
+    void add(glm::vec2 position, float size);
+    // Remove the object in a slot. The last object is moved into the freed slot to keep the arrays packed.
+    void remove(uint32_t index);
+    void setPosition(uint32_t index, glm::vec2 position);
+    uint32_t size() const { return positions.size(); }
+
+    // Find the first object along the segment from start to end that is closer then (object size + margin) to the segment.
+    // Objects for which skip(index) returns true are ignored.
+    template<typename F> bool querySegment(glm::vec2 start, glm::vec2 end, float margin, Result& result, F skip) const;
+    bool querySegment(glm::vec2 start, glm::vec2 end, float margin, Result& result) const
+    {
+        return querySegment(start, end, margin, result, [](uint32_t) { return false; });
+    }
+
+private:
+    static constexpr float sector_size = 5000.0f;
+    static constexpr float small_object_max_size = 1000.0f;
+    // Sector key used to mark big objects, which are not stored in the sector grid.
+    static constexpr uint64_t big_object_key = ~uint64_t(0);
+
+    std::vector<glm::vec2> positions;
+    std::vector<float> sizes;
+    std::vector<uint64_t> sector_keys;
+    std::vector<uint32_t> big_objects;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> sectors;
+
+    static int32_t positionToSector(float f);
+    static uint64_t sectorKey(int32_t x, int32_t y) { return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(y)); }
+    static uint64_t positionKey(glm::vec2 position) { return sectorKey(positionToSector(position.x), positionToSector(position.y)); }
+    void removeFromSector(uint64_t key, uint32_t index);
+    void replaceIndex(uint32_t old_index, uint32_t new_index);
+};
+
+template<typename F> bool AvoidObjectGrid::querySegment(glm::vec2 start, glm::vec2 end, float margin, Result& result, F skip) const
+{
+    glm::vec2 startEndDiff = end - start;
+    float startEndLength = glm::length(startEndDiff);
+    if (startEndLength <= 0.0f)
+        return false;
+    glm::vec2 direction = startEndDiff / startEndLength;
+    float firstAvoidF = startEndLength;
+    int firstAvoidIndex = -1;
+
+    auto check = [&](uint32_t index)
+    {
+        if (skip(index))
+            return;
+        glm::vec2 position = positions[index];
+        float size = sizes[index];
+        float f = glm::dot(direction, position - start);
+        if (f > 0 && f < startEndLength - size && f < firstAvoidF)
+        {
+            glm::vec2 q = start + direction * f;
+            if (glm::length2(q - position) < (size + margin) * (size + margin))
+            {
+                firstAvoidIndex = index;
+                firstAvoidF = f;
+                result.closest = q;
+            }
+        }
+    };
+
+    for(uint32_t index : big_objects)
+        check(index);
+
+    if (!sectors.empty())
+    {
+        // Bresenham's line algorithm to walk the sectors between start and end.
+        int x1 = positionToSector(start.x);
+        int y1 = positionToSector(start.y);
+        int x2 = positionToSector(end.x);
+        int y2 = positionToSector(end.y);
+
+        const bool steep = abs(y2 - y1) > abs(x2 - x1);
+        if(steep)
+        {
+            std::swap(x1, y1);
+            std::swap(x2, y2);
+        }
+
+        if(x1 > x2)
+        {
+            std::swap(x1, x2);
+            std::swap(y1, y2);
+        }
+
+        const int dx = x2 - x1;
+        const int dy = abs(y2 - y1);
+
+        int error = dx / 2;
+        const int ystep = (y1 < y2) ? 1 : -1;
+        int y = y1;
+
+        for(int x=x1; x<=x2; x++)
+        {
+            auto it = sectors.find(steep ? sectorKey(y, x) : sectorKey(x, y));
+            if (it != sectors.end())
+            {
+                for(uint32_t index : it->second)
+                    check(index);
+            }
+
+            error -= dy;
+            if(error < 0)
+            {
+                y += ystep;
+                error += dx;
+            }
+        }
+    }
+
+    if (firstAvoidIndex < 0)
+        return false;
+    result.index = firstAvoidIndex;
+    result.position = positions[firstAvoidIndex];
+    result.size = sizes[firstAvoidIndex];
+    return true;
+}
+
+#endif//AVOID_OBJECT_GRID_H
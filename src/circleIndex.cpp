@@ -0,0 +1,161 @@
+#include "circleIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+CircleIndex::CircleIndex(float cell_size, radius_function_t radius_function)
+: cell_size(cell_size), radius_function(radius_function)
+{
+}
+
+void CircleIndex::add(P<SpaceObject> obj)
+{
+    objects.push_back(obj);
+    positions.push_back(obj->getPosition());
+    radii.push_back(radius_function(*obj));
+    dirty = true;
+}
+
+void CircleIndex::update(float delta)
+{
+    for(unsigned int n=0; n<objects.size(); )
+    {
+        if (!objects[n])
+        {
+            objects[n] = objects.back();
+            positions[n] = positions.back();
+            radii[n] = radii.back();
+            objects.pop_back();
+            positions.pop_back();
+            radii.pop_back();
+            dirty = true;
+            continue;
+        }
+
+        auto position = objects[n]->getPosition();
+        float radius = radius_function(*objects[n]);
+        if (position != positions[n] || radius != radii[n])
+        {
+            positions[n] = position;
+            radii[n] = radius;
+            dirty = true;
+        }
+        n++;
+    }
+}
+
+bool CircleIndex::anyContains(glm::vec2 position)
+{
+    if (dirty)
+        rebuild();
+
+    auto it = cells.find(cellKey(toCell(position.x), toCell(position.y)));
+    if (it == cells.end())
+        return false;
+    for(uint32_t index : it->second)
+    {
+        if (objects[index] && glm::length2(positions[index] - position) < radii[index] * radii[index])
+            return true;
+    }
+    return false;
+}
+
+bool CircleIndex::anyOnSegment(glm::vec2 start, glm::vec2 end)
+{
+    if (dirty)
+        rebuild();
+    if (cells.empty())
+        return false;
+
+    glm::vec2 diff = end - start;
+    float length2 = glm::length2(diff);
+
+    // Walk all cells that the segment passes trough (Amanatides & Woo grid traversal).
+    int x = toCell(start.x);
+    int y = toCell(start.y);
+    int end_x = toCell(end.x);
+    int end_y = toCell(end.y);
+    int step_x = diff.x > 0.0f ? 1 : -1;
+    int step_y = diff.y > 0.0f ? 1 : -1;
+    float t_delta_x = diff.x != 0.0f ? cell_size / std::abs(diff.x) : std::numeric_limits<float>::infinity();
+    float t_delta_y = diff.y != 0.0f ? cell_size / std::abs(diff.y) : std::numeric_limits<float>::infinity();
+    float t_max_x = diff.x != 0.0f ? ((x + (step_x > 0 ? 1 : 0)) * cell_size - start.x) / diff.x : std::numeric_limits<float>::infinity();
+    float t_max_y = diff.y != 0.0f ? ((y + (step_y > 0 ? 1 : 0)) * cell_size - start.y) / diff.y : std::numeric_limits<float>::infinity();
+
+    int steps = std::abs(end_x - x) + std::abs(end_y - y);
+    if (segmentHitsCell(x, y, start, diff, length2))
+        return true;
+    for(int n=0; n<steps; n++)
+    {
+        if (y == end_y || (x != end_x && t_max_x < t_max_y))
+        {
+            t_max_x += t_delta_x;
+            x += step_x;
+        }else{
+            t_max_y += t_delta_y;
+            y += step_y;
+        }
+        if (segmentHitsCell(x, y, start, diff, length2))
+            return true;
+    }
+    return false;
+}
+
+uint32_t CircleIndex::getGeneration()
+{
+    if (dirty)
+        rebuild();
+    return generation;
+}
+
+bool CircleIndex::segmentHitsCell(int x, int y, glm::vec2 start, glm::vec2 diff, float length2)
+{
+    auto it = cells.find(cellKey(x, y));
+    if (it == cells.end())
+        return false;
+    for(uint32_t index : it->second)
+    {
+        if (!objects[index])
+            continue;
+        //Calculate point q, which is a point on the line start-end that is closest to the circle center
+        float f = 0.0f;
+        if (length2 > 0.0f)
+            f = std::clamp(glm::dot(diff, positions[index] - start) / length2, 0.0f, 1.0f);
+        auto q = start + diff * f;
+        if (glm::length2(q - positions[index]) < radii[index] * radii[index])
+            return true;
+    }
+    return false;
+}
+
+int CircleIndex::toCell(float f) const
+{
+    return static_cast<int>(std::floor(f / cell_size));
+}
+
+uint64_t CircleIndex::cellKey(int32_t x, int32_t y)
+{
+    return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(y));
+}
+
+void CircleIndex::rebuild()
+{
+    dirty = false;
+    generation++;
+    cells.clear();
+    for(uint32_t index=0; index<objects.size(); index++)
+    {
+        if (!objects[index])
+            continue;
+        positions[index] = objects[index]->getPosition();
+        radii[index] = radius_function(*objects[index]);
+        float r = radii[index];
+        int x1 = toCell(positions[index].x - r);
+        int y1 = toCell(positions[index].y - r);
+        int x2 = toCell(positions[index].x + r);
+        int y2 = toCell(positions[index].y + r);
+        for(int x=x1; x<=x2; x++)
+            for(int y=y1; y<=y2; y++)
+                cells[cellKey(x, y)].push_back(index);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CIRCLE_INDEX_H
+#define CIRCLE_INDEX_H
+
+#include "spaceObjects/spaceObject.h"
+#include "Updatable.h"
+#include <vector>
+#include <unordered_map>
+
+// Uniform grid over circular areas of static(ish) objects, like nebulae and warp jammers.
+// The circles are kept in flat arrays and bucketed in every grid cell they overlap.
+// Each update the registered objects are checked for movement, resizing or destruction,
+// and the grid is rebuild lazily at the next query when anything changed.
+class CircleIndex : public Updatable
+{
+public:
+    typedef float (*radius_function_t)(SpaceObject* obj);
+
+    CircleIndex(float cell_size, radius_function_t radius_function);
+
+    void add(P<SpaceObject> obj);
+
+    // True if the position is inside any circle.
+    bool anyContains(glm::vec2 position);
+    // True if any circle intersects the line segment from start to end.
+    bool anyOnSegment(glm::vec2 start, glm::vec2 end);
+    // Counter that changes every time the circles in the index change, usable to invalidate cached query results.
+    uint32_t getGeneration();
+
+    virtual void update(float delta) override;
+private:
+    float cell_size;
+    radius_function_t radius_function;
+    bool dirty = false;
+    uint32_t generation = 0;
+
+    std::vector<P<SpaceObject>> objects;
+    std::vector<glm::vec2> positions;
+    std::vector<float> radii;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+
+    int toCell(float f) const;
+    static uint64_t cellKey(int32_t x, int32_t y);
+    void rebuild();
+    bool segmentHitsCell(int x, int y, glm::vec2 start, glm::vec2 diff, float length2);
+};
+
+#endif//CIRCLE_INDEX_H
@@ -0,0 +1,152 @@
+#include "effectChannel.h"
+#include "multiplayer_server.h"
+#include "soundManager.h"
+#include "random.h"
+#include "spaceObjects/explosionEffect.h"
+#include "spaceObjects/electricExplosionEffect.h"
+
+#include <glm/ext/matrix_transform.hpp>
+
+EffectChannel* EffectChannel::instance = nullptr;
+std::vector<EffectChannel::LocalEffect> EffectChannel::local_effects;
+
+REGISTER_MULTIPLAYER_CLASS(EffectChannel, "EffectChannel");
+EffectChannel::EffectChannel()
+: MultiplayerObject("EffectChannel")
+{
+    instance = this;
+
+    ring_head = 0;
+    processed_head = -1;
+    dropped_effects = 0;
+    registerMemberReplication(&ring_head);
+    for(int n=0; n<ring_size; n++)
+    {
+        ring_type[n] = 0;
+        ring_position[n] = glm::vec2(0, 0);
+        ring_effect_size[n] = 0.0f;
+        ring_radar_signature[n] = glm::vec3(0, 0, 0);
+        registerMemberReplication(&ring_type[n]);
+        registerMemberReplication(&ring_position[n]);
+        registerMemberReplication(&ring_effect_size[n]);
+        registerMemberReplication(&ring_radar_signature[n]);
+    }
+}
+
+EffectChannel::~EffectChannel()
+{
+    if (instance == this)
+        instance = nullptr;
+}
+
+void EffectChannel::update(float delta)
+{
+    if (!game_server)
+    {
+        //Do not replay the effects that were spawned before we joined.
+        if (processed_head < 0)
+            processed_head = ring_head;
+        //When more effects were spawned than fit in the ring since the last update, the oldest ones are lost.
+        if (ring_head - processed_head > ring_size)
+        {
+            dropped_effects += ring_head - processed_head - ring_size;
+            processed_head = ring_head - ring_size;
+            LOG(WARNING) << "Effect channel overflowed, " << dropped_effects << " effects dropped in total";
+        }
+        for(; processed_head < ring_head; processed_head++)
+        {
+            int idx = processed_head % ring_size;
+            glm::vec3 signature = ring_radar_signature[idx];
+            spawnLocal(EEffectType(ring_type[idx] & ~on_radar_flag), ring_position[idx], ring_effect_size[idx], (ring_type[idx] & on_radar_flag) != 0, RawRadarSignatureInfo(signature.x, signature.y, signature.z));
+        }
+    }
+
+    for(unsigned int n=0; n<local_effects.size(); )
+    {
+        LocalEffect& effect = local_effects[n];
+        if (delta > 0 && !effect.sound_played)
+        {
+            effect.sound_played = true;
+            switch(effect.type)
+            {
+            case Explosion: soundManager->playSound("sfx/explosion.wav", effect.position, effect.size * 2, 60.0); break;
+            case NukeExplosion: soundManager->playSound("sfx/nuke_explosion.wav", effect.position, effect.size * 2, 60.0); break;
+            case ElectricExplosion: soundManager->playSound("sfx/emp_explosion.wav", effect.position, effect.size * 2, 60.0); break;
+            }
+        }
+        effect.lifetime -= delta;
+        if (effect.lifetime < 0)
+        {
+            local_effects[n] = local_effects.back();
+            local_effects.pop_back();
+        }else{
+            n++;
+        }
+    }
+}
+
+void EffectChannel::spawn(EEffectType type, glm::vec2 position, float size, bool on_radar, RawRadarSignatureInfo radar_signature)
+{
+    if (!game_server)
+        return;
+    if (instance)
+    {
+        int idx = instance->ring_head % ring_size;
+        instance->ring_type[idx] = int32_t(type) | (on_radar ? on_radar_flag : 0);
+        instance->ring_position[idx] = position;
+        instance->ring_effect_size[idx] = size;
+        instance->ring_radar_signature[idx] = glm::vec3(radar_signature.gravity, radar_signature.electrical, radar_signature.biological);
+        instance->ring_head++;
+    }
+    spawnLocal(type, position, size, on_radar, radar_signature);
+}
+
+void EffectChannel::spawnLocal(EEffectType type, glm::vec2 position, float size, bool on_radar, RawRadarSignatureInfo radar_signature)
+{
+    LocalEffect effect;
+    effect.type = type;
+    effect.position = position;
+    effect.size = size;
+    effect.lifetime = getMaxLifetime(type);
+    effect.on_radar = on_radar;
+    effect.sound_played = false;
+    effect.radar_signature = radar_signature;
+    local_effects.push_back(effect);
+}
+
+float EffectChannel::getMaxLifetime(EEffectType type)
+{
+    if (type == ElectricExplosion)
+        return ElectricExplosionEffect::maxLifetime;
+    return ExplosionEffect::maxLifetime;
+}
+
+void EffectChannel::render(const std::vector<const LocalEffect*>& effects)
+{
+    if (effects.empty())
+        return;
+
+    //All pooled effects of a type share their particle directions and buffers.
+    static glm::vec3 explosion_particles[ExplosionEffect::particleCount];
+    static glm::vec3 electric_particles[ElectricExplosionEffect::particleCount];
+    static gl::Buffers<2> explosion_buffers{ gl::Unitialized{} };
+    static gl::Buffers<2> electric_buffers{ gl::Unitialized{} };
+    static bool particles_initialized = false;
+    if (!particles_initialized)
+    {
+        for(int n=0; n<ExplosionEffect::particleCount; n++)
+            explosion_particles[n] = glm::normalize(glm::vec3(random(-1, 1), random(-1, 1), random(-1, 1))) * random(0.8f, 1.2f);
+        for(int n=0; n<ElectricExplosionEffect::particleCount; n++)
+            electric_particles[n] = glm::normalize(glm::vec3(random(-1, 1), random(-1, 1), random(-1, 1))) * random(0.8f, 1.2f);
+        particles_initialized = true;
+    }
+
+    for(const LocalEffect* effect : effects)
+    {
+        auto model_matrix = glm::translate(glm::identity<glm::mat4>(), glm::vec3{ effect->position.x, effect->position.y, 0.f });
+        if (effect->type == ElectricExplosion)
+            ElectricExplosionEffect::render(model_matrix, effect->size, effect->lifetime, electric_particles, electric_buffers);
+        else
+            ExplosionEffect::render(model_matrix, effect->size, effect->lifetime, explosion_particles, explosion_buffers);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef EFFECT_CHANNEL_H
+#define EFFECT_CHANNEL_H
+
+#include "engine.h"
+#include "multiplayer.h"
+#include "spaceObjects/spaceObject.h"
+#include "glObjects.h"
+
+//Short lived visual effects spawned by the game (explosions), without creating a replicated SpaceObject for each of them.
+//The server writes each spawned effect into a small replicated ring, clients pick up new entries from the ring,
+//and every instance renders the effects from a local pool.
+//Scripts can still create ExplosionEffect and ElectricExplosionEffect objects directly.
+class EffectChannel : public MultiplayerObject, public Updatable
+{
+public:
+    enum EEffectType
+    {
+        Explosion,
+        NukeExplosion,
+        ElectricExplosion
+    };
+
+    class LocalEffect
+    {
+    public:
+        EEffectType type;
+        glm::vec2 position;
+        float size;
+        float lifetime;
+        bool on_radar;
+        bool sound_played;
+        RawRadarSignatureInfo radar_signature;
+    };
+
+    //Radius of effects, the same as the object radius of the effect SpaceObjects.
+    //Used for their radar signature and to sort them into the render lists of the 3D view.
+    static constexpr float effect_radius = 1000.0f;
+
+    EffectChannel();
+    virtual ~EffectChannel();
+
+    virtual void update(float delta) override;
+
+    //Spawn an effect. Only has effect on the server, which forwards it to all clients.
+    static void spawn(EEffectType type, glm::vec2 position, float size, bool on_radar, RawRadarSignatureInfo radar_signature = RawRadarSignatureInfo());
+
+    static const std::vector<LocalEffect>& getLocalEffects() { return local_effects; }
+    //Render the given local effects, in the transparent pass of the 3D view.
+    static void render(const std::vector<const LocalEffect*>& effects);
+private:
+    static constexpr int ring_size = 64;
+    static constexpr int32_t on_radar_flag = 0x100;
+
+    static EffectChannel* instance;
+    static std::vector<LocalEffect> local_effects;
+
+    //Ring of the last spawned effects. ring_head counts all effects ever spawned, the newest one is at (ring_head - 1) % ring_size.
+    int32_t ring_head;
+    int32_t ring_type[ring_size];
+    glm::vec2 ring_position[ring_size];
+    float ring_effect_size[ring_size];
+    glm::vec3 ring_radar_signature[ring_size];
+    int32_t processed_head;
+    //Effects that were overwritten in the ring before this client received them.
+    int dropped_effects;
+
+    static void spawnLocal(EEffectType type, glm::vec2 position, float size, bool on_radar, RawRadarSignatureInfo radar_signature);
+    static float getMaxLifetime(EEffectType type);
+};
+
+#endif//EFFECT_CHANNEL_H
@@ -1,6 +1,7 @@
 #include "epsilonServer.h"
 #include "playerInfo.h"
 #include "gameGlobalInfo.h"
+#include "effectChannel.h"
 #include "soundManager.h"
 #include "multiplayer_client.h"
 #include "preferenceManager.h"
@@ -14,6 +15,7 @@ EpsilonServer::EpsilonServer()
     {
         new GameGlobalInfo();
         new GameMasterActions();
+        new EffectChannel();
         PlayerInfo* info = new PlayerInfo();
         info->client_id = 0;
         my_player_info = info;
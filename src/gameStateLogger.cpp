@@ -1,11 +1,14 @@
 #include <memory>
+#include <algorithm>
 #include <time.h>
 
 //We need a really fast float to string conversion. dtoa from milo does this very well.
 #include "dtoa/dtoa_milo.h"
 
 #include "gameStateLogger.h"
+#include "jsonGenerator.h"
 #include "gameGlobalInfo.h"
+#include "preferenceManager.h"
 #include "spaceObjects/spaceObject.h"
 #include "spaceObjects/asteroid.h"
 #include "spaceObjects/mine.h"
@@ -15,111 +18,15 @@
 #include "spaceObjects/missiles/missileWeapon.h"
 #include "spaceObjects/planet.h"
 
-class JSONGenerator
-{
-public:
-    JSONGenerator(char*& ptr)
-    : ptr(ptr), first(true)
-    {
-        *ptr++ = '{';
-    }
-
-    ~JSONGenerator()
-    {
-        *ptr++ = '}';
-    }
-
-    template<typename T> void write(const char* key, const T& value)
-    {
-        if (!first)
-            *ptr++ = ',';
-        *ptr++ = '"';
-        while(*key)
-            *ptr++ = *key++;
-        *ptr++ = '"';
-        *ptr++ = ':';
-        first = false;
-        writeValue(value);
-    }
-    JSONGenerator createDict(const char* key)
-    {
-        if (!first)
-            *ptr++ = ',';
-        *ptr++ = '"';
-        while(*key)
-            *ptr++ = *key++;
-        *ptr++ = '"';
-        *ptr++ = ':';
-        first = false;
-        return JSONGenerator(ptr);
-    }
-    void startArray(const char* key)
-    {
-        if (!first)
-            *ptr++ = ',';
-        *ptr++ = '"';
-        while(*key)
-            *ptr++ = *key++;
-        *ptr++ = '"';
-        *ptr++ = ':';
-        *ptr++ = '[';
-        first = false;
-        array_first = true;
-    }
-    JSONGenerator arrayCreateDict()
-    {
-        if (!array_first)
-            *ptr++ = ',';
-        array_first = false;
-        return JSONGenerator(ptr);
-    }
-    template<typename T> void arrayWrite(const T& value)
-    {
-        if (!array_first)
-            *ptr++ = ',';
-        array_first = false;
-        writeValue(value);
-    }
-    void endArray()
-    {
-        *ptr++ = ']';
-        first = false;
-        array_first = true;
-    }
-private:
-    void writeValue(bool b)
-    {
-        const char* c = "false";
-        if (b) c = "true";
-        while(*c)
-            *ptr++ = *c++;
-    }
-    void writeValue(int i) { ptr += sprintf(ptr, "%d", i); }
-    void writeValue(float _f) { dtoa_milo(_f, ptr); ptr += strlen(ptr); }
-    void writeValue(const char* value)
-    { /*ptr += sprintf(ptr, "\"%s\"", value);*/
-        *ptr++ = '"';
-        while(*value)
-            *ptr++ = *value++;
-        *ptr++ = '"';
-    }
-    void writeValue(const string& value)
-    {
-        const char* str = value.c_str();
-        *ptr++ = '"';
-        while(*str)
-            *ptr++ = *str++;
-        *ptr++ = '"';
-    }
-
-    char*& ptr;
-    bool first, array_first;
-};
-
 GameStateLogger::GameStateLogger()
 {
     log_file = nullptr;
-    logging_interval = 1.0;
+    format = PreferencesManager::get("game_logs_format", "json") == "binary" ? Format::Binary : Format::JSON;
+    state_count = 0;
+    run_writer_thread = false;
+    dropped_states = 0;
+    logging_interval = std::max(0.02f, PreferencesManager::get("game_logs_interval", "1.0").toFloat());
+    binary_keyframe_interval = std::max(1, int(binary_keyframe_time / logging_interval));
     logging_delay = 0.0;
 }
 
@@ -134,21 +41,93 @@ void GameStateLogger::start()
     char filename_buffer[128];
 
     rawtime = time(nullptr);
-    strftime(filename_buffer, sizeof(filename_buffer), "logs/game_log_%d-%m-%Y_%H.%M.%S.txt", localtime(&rawtime));
-    log_file = fopen(filename_buffer, "wt");
+    if (format == Format::Binary)
+    {
+        strftime(filename_buffer, sizeof(filename_buffer), "logs/game_log_%d-%m-%Y_%H.%M.%S.bin", localtime(&rawtime));
+        log_file = fopen(filename_buffer, "wb");
+        if (log_file)
+            fwrite("EEGL\x01", 1, 5, log_file);
+    }else{
+        strftime(filename_buffer, sizeof(filename_buffer), "logs/game_log_%d-%m-%Y_%H.%M.%S.txt", localtime(&rawtime));
+        log_file = fopen(filename_buffer, "wt");
+    }
     if (log_file)
+    {
         LOG(INFO) << "Opened game state log: " << filename_buffer;
+        run_writer_thread = true;
+        writer_thread = std::thread(&GameStateLogger::writerLoop, this);
+    }
     else
+    {
         LOG(WARNING) << "Failed to open game state log file: " << filename_buffer;
+    }
     start_time = engine->getElapsedTime();
 }
 
 void GameStateLogger::stop()
 {
+    if (run_writer_thread)
+    {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex);
+            run_writer_thread = false;
+        }
+        writer_condition.notify_one();
+        writer_thread.join();
+    }
     if (log_file)
     {
         fclose(log_file);
         log_file = nullptr;
+        if (dropped_states > 0)
+            LOG(WARNING) << "Game state log dropped " << dropped_states << " states because writing to disk was too slow";
+    }
+}
+
+bool GameStateLogger::writerBusy()
+{
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    return pending_writes.size() >= max_pending_writes;
+}
+
+void GameStateLogger::appendWrite(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    current_write.insert(current_write.end(), bytes, bytes + size);
+}
+
+void GameStateLogger::finishWrite()
+{
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    pending_writes.emplace_back(std::move(current_write));
+    if (!free_write_buffers.empty())
+    {
+        current_write = std::move(free_write_buffers.back());
+        free_write_buffers.pop_back();
+    }
+    else
+    {
+        current_write = std::vector<uint8_t>();
+    }
+    current_write.clear();
+    writer_condition.notify_one();
+}
+
+void GameStateLogger::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    while(true)
+    {
+        writer_condition.wait(lock, [this]() { return !pending_writes.empty() || !run_writer_thread; });
+        if (pending_writes.empty())
+            break;
+
+        std::vector<uint8_t> buffer = std::move(pending_writes.front());
+        pending_writes.pop_front();
+        lock.unlock();
+        fwrite(buffer.data(), 1, buffer.size(), log_file);
+        lock.lock();
+        free_write_buffers.emplace_back(std::move(buffer));
     }
 }
 
@@ -162,7 +141,111 @@ void GameStateLogger::update(float delta)
         return;
     logging_delay = logging_interval;
 
-    logGameState();
+    if (writerBusy())
+    {
+        // Skip this state entirely. The binary log restarts with a keyframe, so the states that do get logged stay complete.
+        // The known static objects are kept, so statics destroyed in the meantime still show up as deleted in the next state.
+        dropped_states++;
+        state_count = 0;
+        return;
+    }
+
+    if (format == Format::Binary)
+    {
+        logEventsBinary();
+        logGameStateBinary();
+    }else{
+        logEvents();
+        logGameState();
+    }
+}
+
+void GameStateLogger::logEvent(EEventType type, P<SpaceObject> source, P<SpaceObject> target, float value)
+{
+    if (!gameGlobalInfo || !gameGlobalInfo->state_logger)
+        return;
+    P<GameStateLogger> logger = gameGlobalInfo->state_logger;
+    if (!logger->log_file || !source)
+        return;
+    if (logger->events.size() >= max_pending_events)
+        return;
+    logger->events.push_back({type, engine->getElapsedTime() - logger->start_time, int(source->getMultiplayerId()), target ? int(target->getMultiplayerId()) : -1, source->getPosition(), value});
+}
+
+static const char* getEventName(GameStateLogger::EEventType type)
+{
+    switch(type)
+    {
+    case GameStateLogger::EEventType::BeamFire: return "beam_fire";
+    case GameStateLogger::EEventType::MissileLaunch: return "missile_launch";
+    case GameStateLogger::EEventType::Damage: return "damage";
+    case GameStateLogger::EEventType::Destroyed: return "destroyed";
+    case GameStateLogger::EEventType::Docked: return "docked";
+    case GameStateLogger::EEventType::Scanned: return "scanned";
+    }
+    return "unknown";
+}
+
+/* Write an event entry, in json format. The event entry looks like:
+    {
+        "type": "event",
+        "time": game time passed since start of logging,
+        "event": "beam_fire", "missile_launch", "damage", "destroyed", "docked" or "scanned",
+        "source": id of the object causing the event (the firing, damaged, destroyed, docking or scanning object),
+        "target": id of the object targeted by the event (beam target, launched missile, instigator of damage, docking target or scanned object), if any,
+        "position": position of the source object,
+        "value": beam damage, missile type, damage amount or scan state
+    }
+*/
+void GameStateLogger::writeEventEntry(char*& ptr, const Event& event)
+{
+    JSONGenerator json(ptr);
+    json.write("type", "event");
+    json.write("time", event.time);
+    json.write("event", getEventName(event.type));
+    json.write("source", event.source_id);
+    if (event.target_id > -1)
+        json.write("target", event.target_id);
+    json.startArray("position");
+    json.arrayWrite(event.position.x);
+    json.arrayWrite(event.position.y);
+    json.endArray();
+    json.write("value", event.value);
+}
+
+void GameStateLogger::logEvents()
+{
+    char buffer[1024];
+    for(const Event& event : events)
+    {
+        char* ptr = buffer;
+        writeEventEntry(ptr, event);
+        *ptr++ = '\n';
+        appendWrite(buffer, ptr - buffer);
+    }
+    events.clear();
+}
+
+void GameStateLogger::logEventsBinary()
+{
+    if (events.empty())
+        return;
+    binary_record.clear();
+    binary_record.push_back('E');
+    writeBinaryVarint(events.size());
+    char buffer[1024];
+    for(const Event& event : events)
+    {
+        char* ptr = buffer;
+        writeEventEntry(ptr, event);
+        writeBinaryString(buffer, ptr - buffer);
+    }
+    events.clear();
+
+    uint32_t size = binary_record.size();
+    uint8_t size_bytes[4] = {uint8_t(size), uint8_t(size >> 8), uint8_t(size >> 16), uint8_t(size >> 24)};
+    appendWrite(size_bytes, 4);
+    appendWrite(binary_record.data(), binary_record.size());
 }
 
 /* Write the state log entry. All entries are in json format.
@@ -195,7 +278,7 @@ void GameStateLogger::logGameState()
 
                 if ((unsigned int)(ptr - log_line_buffer) > sizeof(log_line_buffer) / 2)
                 {
-                    fwrite(log_line_buffer, 1, ptr - log_line_buffer, log_file);
+                    appendWrite(log_line_buffer, ptr - log_line_buffer);
                     ptr = log_line_buffer;
                 }
             }
@@ -230,7 +313,7 @@ void GameStateLogger::logGameState()
 
             if ((unsigned int)(ptr - log_line_buffer) > sizeof(log_line_buffer) / 2)
             {
-                fwrite(log_line_buffer, 1, ptr - log_line_buffer, log_file);
+                appendWrite(log_line_buffer, ptr - log_line_buffer);
                 ptr = log_line_buffer;
             }
         }
@@ -238,8 +321,185 @@ void GameStateLogger::logGameState()
     }
 
     *ptr++ = '\n';
-    *ptr = '\0';
-    fwrite(log_line_buffer, 1, ptr - log_line_buffer, log_file);
+    appendWrite(log_line_buffer, ptr - log_line_buffer);
+    finishWrite();
+}
+
+/* Write a state record to the binary log. Records contain the same information as the json state entries.
+   Each record is prefixed with its size as 32 bit little endian integer, and looks like:
+    uint8   'K' for keyframes, 'D' for delta states
+    string  game time passed since start of logging, as json number
+    varint  new_static count, followed by that many object entries
+    varint  del_static count, followed by that many object ids as varint
+    varint  objects count, followed by that many object entries
+   Keyframes are followed by:
+    varint  static object count, followed by full object entries for all known static objects.
+   Events are written in separate records, containing:
+    uint8   'E'
+    varint  event count, followed by that many json event entries as string.
+   Strings are a varint length followed by the bytes.
+   Object entries are a varint object id, followed by a mode byte:
+    0: Full entry, followed by the json object as string.
+    1: Delta entry. Followed by the varint amount of comma separated tokens in the json object, a bitmask of which tokens
+       changed compared to the last full entry of this object, and a string for each changed token.
+    2: Unchanged, the entry is identical to the last full entry of this object.
+*/
+void GameStateLogger::logGameStateBinary()
+{
+    bool keyframe = (state_count % binary_keyframe_interval) == 0;
+    state_count++;
+    if (keyframe)
+        binary_base_entries.clear();
+
+    binary_record.clear();
+    binary_record.push_back(keyframe ? 'K' : 'D');
+    {
+        char time_buffer[32];
+        char* ptr = time_buffer;
+        dtoa_milo(engine->getElapsedTime() - start_time, ptr);
+        writeBinaryString(time_buffer, strlen(time_buffer));
+    }
+
+    PVector<SpaceObject> new_static;
+    foreach(SpaceObject, obj, space_object_list)
+    {
+        if (isStatic(obj) && static_objects.find(obj->getMultiplayerId()) == static_objects.end())
+        {
+            static_objects[obj->getMultiplayerId()] = obj->getPosition();
+            new_static.push_back(obj);
+        }
+    }
+    writeBinaryVarint(new_static.size());
+    foreach(SpaceObject, obj, new_static)
+        writeBinaryEntry(obj, true);
+
+    std::vector<int> del_list;
+    for(auto it : static_objects)
+    {
+        if (!game_server->getObjectById(it.first))
+            del_list.push_back(it.first);
+    }
+    writeBinaryVarint(del_list.size());
+    for(int id : del_list)
+    {
+        writeBinaryVarint(id);
+        static_objects.erase(id);
+        binary_base_entries.erase(id);
+    }
+
+    PVector<SpaceObject> objects;
+    foreach(SpaceObject, obj, space_object_list)
+    {
+        auto it = static_objects.find(obj->getMultiplayerId());
+        if (it != static_objects.end() && it->second == obj->getPosition())
+            continue;
+        objects.push_back(obj);
+    }
+    writeBinaryVarint(objects.size());
+    foreach(SpaceObject, obj, objects)
+        writeBinaryEntry(obj, keyframe);
+
+    if (keyframe)
+    {
+        PVector<SpaceObject> statics;
+        for(auto it : static_objects)
+        {
+            P<SpaceObject> obj = game_server->getObjectById(it.first);
+            if (obj)
+                statics.push_back(obj);
+        }
+        writeBinaryVarint(statics.size());
+        foreach(SpaceObject, obj, statics)
+            writeBinaryEntry(obj, true);
+    }
+
+    uint32_t size = binary_record.size();
+    uint8_t size_bytes[4] = {uint8_t(size), uint8_t(size >> 8), uint8_t(size >> 16), uint8_t(size >> 24)};
+    appendWrite(size_bytes, 4);
+    appendWrite(binary_record.data(), binary_record.size());
+    finishWrite();
+}
+
+void GameStateLogger::writeBinaryEntry(P<SpaceObject> obj, bool full)
+{
+    static char entry_buffer[1024*256];
+    char* ptr = entry_buffer;
+    {
+        JSONGenerator json(ptr);
+        writeObjectEntry(json, obj);
+    }
+    size_t size = ptr - entry_buffer;
+
+    int id = obj->getMultiplayerId();
+    writeBinaryVarint(id);
+
+    auto it = binary_base_entries.find(id);
+    if (!full && it != binary_base_entries.end())
+    {
+        const std::string& base = it->second;
+        if (base.size() == size && memcmp(base.data(), entry_buffer, size) == 0)
+        {
+            binary_record.push_back(2);
+            return;
+        }
+
+        // Split both entries in comma separated tokens, delta encoding is only possible if the amount of tokens matches.
+        std::vector<std::pair<size_t, size_t>> tokens;
+        size_t token_start = 0;
+        for(size_t n=0; n<=size; n++)
+        {
+            if (n == size || entry_buffer[n] == ',')
+            {
+                tokens.emplace_back(token_start, n - token_start);
+                token_start = n + 1;
+            }
+        }
+        size_t base_token_count = std::count(base.begin(), base.end(), ',') + 1;
+        if (base_token_count == tokens.size())
+        {
+            std::vector<uint8_t> mask((tokens.size() + 7) / 8, 0);
+            std::vector<size_t> changed;
+            size_t base_start = 0;
+            for(size_t n=0; n<tokens.size(); n++)
+            {
+                size_t base_end = base.find(',', base_start);
+                if (base_end == std::string::npos)
+                    base_end = base.size();
+                if (base_end - base_start != tokens[n].second || memcmp(base.data() + base_start, entry_buffer + tokens[n].first, tokens[n].second) != 0)
+                {
+                    mask[n / 8] |= 1 << (n % 8);
+                    changed.push_back(n);
+                }
+                base_start = base_end + 1;
+            }
+            binary_record.push_back(1);
+            writeBinaryVarint(tokens.size());
+            binary_record.insert(binary_record.end(), mask.begin(), mask.end());
+            for(size_t n : changed)
+                writeBinaryString(entry_buffer + tokens[n].first, tokens[n].second);
+            return;
+        }
+    }
+
+    binary_record.push_back(0);
+    writeBinaryString(entry_buffer, size);
+    binary_base_entries[id].assign(entry_buffer, size);
+}
+
+void GameStateLogger::writeBinaryVarint(uint32_t value)
+{
+    while(value >= 0x80)
+    {
+        binary_record.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    binary_record.push_back(uint8_t(value));
+}
+
+void GameStateLogger::writeBinaryString(const char* data, size_t size)
+{
+    writeBinaryVarint(size);
+    binary_record.insert(binary_record.end(), data, data + size);
 }
 
 bool GameStateLogger::isStatic(P<SpaceObject> obj)
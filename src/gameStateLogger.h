@@ -2,6 +2,13 @@
 #define GAME_STATE_LOGGER_H
 
 #include "Updatable.h"
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class SpaceObject;
 class SpaceShip;
@@ -11,16 +18,32 @@ class Planet;
 class JSONGenerator;
 /*
  * The GameStateLogger logs the current state of the game to a log file.
- * It does this every X seconds.
+ * It does this every X seconds, configured with the "game_logs_interval" preference (default 1 second).
  * This logged data can be used to analyze the game afterwards.
  *
  * The resulting log contains 2 types of records:
  * 1) Periodic game data, update of all the objects in the game with all states.
  * 2) Events fired by certain actions. Missile firing, beams firing, damage, destruction of certain objects.
+ *
+ * The log is written as json lines, or in a compact binary format when the "game_logs_format" preference is set to "binary".
+ * Binary logs can be converted back to json lines with game_log_convert.py.
+ *
+ * States are serialized on the main thread, but written to disk by a separate writer thread, so slow disks do not stall the game.
+ * When the writer thread falls behind, states are dropped instead of blocking the game.
  */
 class GameStateLogger : public Updatable
 {
 public:
+    enum class EEventType
+    {
+        BeamFire,
+        MissileLaunch,
+        Damage,
+        Destroyed,
+        Docked,
+        Scanned
+    };
+
     GameStateLogger();
     virtual ~GameStateLogger();
 
@@ -29,14 +52,67 @@ public:
 
     virtual void update(float delta) override;
 
+    // Add an event to the log of the current game, if there is one. Events are written before the next state entry.
+    static void logEvent(EEventType type, P<SpaceObject> source, P<SpaceObject> target=nullptr, float value=0.0f);
 private:
+    class Event
+    {
+    public:
+        EEventType type;
+        float time;
+        int source_id;
+        int target_id;
+        glm::vec2 position;
+        float value;
+    };
+    // Events are dropped when more then this amount are waiting to be written.
+    static constexpr size_t max_pending_events = 100000;
+
+    enum class Format
+    {
+        JSON,
+        Binary
+    };
+    // Time between keyframes in the binary log. Keyframes contain full entries for all objects so they can be used as seek point.
+    static constexpr float binary_keyframe_time = 30.0f;
+    // Maximum amount of serialized states waiting for the writer thread before new states are dropped.
+    static constexpr size_t max_pending_writes = 4;
+
     FILE* log_file;
+    Format format;
+    unsigned int state_count;
+    unsigned int binary_keyframe_interval;
+    std::vector<Event> events;
+    // Last full entry written for each object in the binary log, which delta entries are encoded against.
+    std::unordered_map<int, std::string> binary_base_entries;
+    std::vector<uint8_t> binary_record;
+
+    std::thread writer_thread;
+    std::mutex writer_mutex;
+    std::condition_variable writer_condition;
+    std::deque<std::vector<uint8_t>> pending_writes;
+    std::vector<std::vector<uint8_t>> free_write_buffers;
+    std::vector<uint8_t> current_write;
+    bool run_writer_thread;
+    unsigned int dropped_states;
     float logging_interval;
     float logging_delay;
     float start_time;
     std::map<int, glm::vec2> static_objects;
 
+    bool writerBusy();
+    void appendWrite(const void* data, size_t size);
+    void finishWrite();
+    void writerLoop();
+
+    void logEvents();
+    void logEventsBinary();
+    void writeEventEntry(char*& ptr, const Event& event);
     void logGameState();
+    void logGameStateBinary();
+    void writeBinaryEntry(P<SpaceObject> obj, bool full);
+    void writeBinaryVarint(uint32_t value);
+    void writeBinaryString(const char* data, size_t size);
     bool isStatic(P<SpaceObject> obj);
     void writeObjectEntry(JSONGenerator& json, P<SpaceObject> obj);
     void writeShipEntry(JSONGenerator& json, P<SpaceShip> obj);
@@ -2,6 +2,8 @@
 #include "main.h"
 #include "multiplayer_server.h"
 #include "hotkeyConfig.h"
+#include "spaceObjects/nebula.h"
+#include "replicationProfiler.h"
 
 
 DebugRenderer::DebugRenderer()
@@ -46,7 +48,11 @@ void DebugRenderer::render(sp::RenderTarget& renderer)
     {
         text = text + string(game_server->getSendDataRate() / 1000, 1) + " kb per second\n";
         text = text + string(game_server->getSendDataRatePerClient() / 1000, 1) + " kb per client\n";
+        if (ReplicationProfiler::isEnabled())
+            text = text + ReplicationProfiler::getOverlayText(5);
     }
+    if (show_datarate)
+        text = text + "Nebula visibility cache: " + string(int(Nebula::getVisibilityCacheHits())) + " hits, " + string(int(Nebula::getVisibilityCacheMisses())) + " misses\n";
 
     if (show_timing_graph)
     {
@@ -40,15 +40,17 @@ void GuiElement::onTextInput(sp::TextInputEvent e)
 
 GuiElement* GuiElement::setSize(glm::vec2 size)
 {
-    this->size = size;
+    if (this->size != size)
+    {
+        this->size = size;
+        layout_dirty = true;
+    }
     return this;
 }
 
 GuiElement* GuiElement::setSize(float x, float y)
 {
-    this->size.x = x;
-    this->size.y = y;
-    return this;
+    return setSize(glm::vec2(x, y));
 }
 
 glm::vec2 GuiElement::getSize() const
@@ -58,38 +60,40 @@ glm::vec2 GuiElement::getSize() const
 
 GuiElement* GuiElement::setMargins(float n)
 {
-    margins.left = margins.top = margins.right = margins.bottom = n;
-    return this;
+    return setMargins(n, n, n, n);
 }
 
 GuiElement* GuiElement::setMargins(float x, float y)
 {
-    margins.left = margins.right = x;
-    margins.top = margins.bottom = y;
-    return this;
+    return setMargins(x, y, x, y);
 }
 
 GuiElement* GuiElement::setMargins(float left, float top, float right, float bottom)
 {
-    margins.left = left;
-    margins.top = top;
-    margins.right = right;
-    margins.bottom = bottom;
+    if (margins.left != left || margins.top != top || margins.right != right || margins.bottom != bottom)
+    {
+        margins.left = left;
+        margins.top = top;
+        margins.right = right;
+        margins.bottom = bottom;
+        layout_dirty = true;
+    }
     return this;
 }
 
 GuiElement* GuiElement::setPosition(float x, float y, sp::Alignment alignment)
 {
-    this->position.x = x;
-    this->position.y = y;
-    this->position_alignment = alignment;
-    return this;
+    return setPosition(glm::vec2(x, y), alignment);
 }
 
 GuiElement* GuiElement::setPosition(glm::vec2 position, sp::Alignment alignment)
 {
-    this->position = position;
-    this->position_alignment = alignment;
+    if (this->position != position || this->position_alignment != alignment)
+    {
+        this->position = position;
+        this->position_alignment = alignment;
+        layout_dirty = true;
+    }
     return this;
 }
 
@@ -203,6 +207,12 @@ bool GuiElement::isDestroyed()
 
 void GuiElement::updateRect(sp::Rect parent_rect)
 {
+    //Only layout again when our layout settings or the rect of our parent changed.
+    if (!layout_dirty && layout_parent_rect.position == parent_rect.position && layout_parent_rect.size == parent_rect.size)
+        return;
+    layout_dirty = false;
+    layout_parent_rect = parent_rect;
+
     glm::vec2 local_size = size;
     if (local_size.x == GuiSizeMax)
         local_size.x = parent_rect.size.x - std::abs(position.x);
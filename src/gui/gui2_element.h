@@ -18,6 +18,9 @@ private:
     } margins {0, 0, 0, 0};
     sp::Alignment position_alignment;
     bool destroyed;
+    //The rect is only calculated again when the layout settings or the parent rect change.
+    bool layout_dirty = true;
+    sp::Rect layout_parent_rect{0, 0, 0, 0};
 protected:
     GuiContainer* owner;
     sp::Rect rect;
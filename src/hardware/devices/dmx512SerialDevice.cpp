@@ -9,6 +9,7 @@ DMX512SerialDevice::DMX512SerialDevice()
         data_stream[n] = 0;
     channel_count = 512;
     resend_delay = 25;
+    keepalive_delay = 1000;
     run_thread = false;
 }
 
@@ -43,8 +44,13 @@ bool DMX512SerialDevice::configure(std::unordered_map<string, string> settings)
     {
         resend_delay = settings["resend_delay"].toInt();
     }
+    if (settings.find("keepalive_delay") != settings.end())
+    {
+        keepalive_delay = std::max(1, settings["keepalive_delay"].toInt());
+    }
     if (port)
     {
+        channel_buffer.resize(channel_count);
         run_thread = true;
         update_thread = std::move(std::thread(&DMX512SerialDevice::updateLoop, this));
         return true;
@@ -56,7 +62,12 @@ bool DMX512SerialDevice::configure(std::unordered_map<string, string> settings)
 void DMX512SerialDevice::setChannelData(int channel, float value)
 {
     if (channel >= 0 && channel < channel_count)
-        data_stream[1+channel] = int((value * 255.0f) + 0.5f);
+        channel_buffer.setChannel(channel, value);
+}
+
+void DMX512SerialDevice::commitChannelData()
+{
+    channel_buffer.publish();
 }
 
 //Return the number of output channels supported by this device.
@@ -73,13 +84,19 @@ void DMX512SerialDevice::updateLoop()
     //Configure the port for straight DMX-512 protocol.
     port->configure(250000, 8, SerialPort::NoParity, SerialPort::TwoStopbits);
 
+    auto last_send = std::chrono::steady_clock::now();
     while(run_thread)
     {
-        //Send a break to initiate transfer, break needs to be at least 88uSec (note, not all USB serial convertors implement BREAK sending)
-        port->sendBreak();
+        auto now = std::chrono::steady_clock::now();
+        if (channel_buffer.fetchDMX(data_stream + 1) || now - last_send >= std::chrono::milliseconds(keepalive_delay))
+        {
+            //Send a break to initiate transfer, break needs to be at least 88uSec (note, not all USB serial convertors implement BREAK sending)
+            port->sendBreak();
 
-        //Send the channel data.
-        port->send(data_stream, 1 + channel_count);
+            //Send the channel data.
+            port->send(data_stream, 1 + channel_count);
+            last_send = now;
+        }
 
         //Delay a bit before sending again.
         std::this_thread::sleep_for(std::chrono::milliseconds(resend_delay));
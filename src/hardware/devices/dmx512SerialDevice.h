@@ -2,6 +2,7 @@
 #define DMX512_SERIAL_DEVICE_H
 
 #include "hardware/hardwareOutputDevice.h"
+#include "hardware/hardwareChannelBuffer.h"
 
 #include <stdint.h>
 #include <thread>
@@ -17,17 +18,22 @@ private:
     bool run_thread;
     int channel_count;
     int resend_delay;
+    int keepalive_delay;
     uint8_t data_stream[1+512];
+    HardwareChannelBuffer channel_buffer;
 public:
     DMX512SerialDevice();
     virtual ~DMX512SerialDevice();
 
     //Configure the device.
     // Parameter: port: name of the serial port to connect to.
+    // Parameter: resend_delay: Minimal time between DMX frames, in ms. Default 25
+    // Parameter: keepalive_delay: Time after which an unchanged DMX frame is sent again, in ms. Default 1000
     virtual bool configure(std::unordered_map<string, string> settings) override;
 
     //Set a hardware channel output. Value is 0.0 to 1.0 for no to max output.
     virtual void setChannelData(int channel, float value) override;
+    virtual void commitChannelData() override;
 
     //Return the number of output channels supported by this device.
     virtual int getChannelCount() override;
@@ -8,6 +8,9 @@ EnttecDMXProDevice::EnttecDMXProDevice()
     for(int n=0; n<512; n++)
         channel_data[n] = 0;
     channel_count = 512;
+    resend_delay = 100;
+    keepalive_delay = 1000;
+    run_thread = false;
 }
 
 EnttecDMXProDevice::~EnttecDMXProDevice()
@@ -37,8 +40,17 @@ bool EnttecDMXProDevice::configure(std::unordered_map<string, string> settings)
     {
         channel_count = std::max(1, std::min(512, settings["channels"].toInt()));
     }
+    if (settings.find("resend_delay") != settings.end())
+    {
+        resend_delay = std::max(1, settings["resend_delay"].toInt());
+    }
+    if (settings.find("keepalive_delay") != settings.end())
+    {
+        keepalive_delay = std::max(1, settings["keepalive_delay"].toInt());
+    }
     if (port)
     {
+        channel_buffer.resize(channel_count);
         run_thread = true;
         update_thread = std::thread(&EnttecDMXProDevice::updateLoop, this);
         return true;
@@ -50,7 +62,12 @@ bool EnttecDMXProDevice::configure(std::unordered_map<string, string> settings)
 void EnttecDMXProDevice::setChannelData(int channel, float value)
 {
     if (channel >= 0 && channel < channel_count)
-        channel_data[channel] = int((value * 255.0f) + 0.5f);
+        channel_buffer.setChannel(channel, value);
+}
+
+void EnttecDMXProDevice::commitChannelData()
+{
+    channel_buffer.publish();
 }
 
 //Return the number of output channels supported by this device.
@@ -67,13 +84,19 @@ void EnttecDMXProDevice::updateLoop()
     int size = channel_count + 1;
     uint8_t start_code[5] = {0x7E, 0x06, uint8_t(size & 0xFF), uint8_t(size >> 8), 0x00};
     uint8_t end_code[1] = {0xE7};
+    auto last_send = std::chrono::steady_clock::now();
     while(run_thread)
     {
-        port->send(start_code, sizeof(start_code));
-        port->send(channel_data, channel_count);
-        port->send(end_code, sizeof(end_code));
+        auto now = std::chrono::steady_clock::now();
+        if (channel_buffer.fetchDMX(channel_data) || now - last_send >= std::chrono::milliseconds(keepalive_delay))
+        {
+            port->send(start_code, sizeof(start_code));
+            port->send(channel_data, channel_count);
+            port->send(end_code, sizeof(end_code));
+            last_send = now;
+        }
 
         //Delay a bit before sending again.
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::this_thread::sleep_for(std::chrono::milliseconds(resend_delay));
     }
 }
@@ -2,6 +2,7 @@
 #define ENTTEC_DMX_PRO_DEVICE_H
 
 #include "hardware/hardwareOutputDevice.h"
+#include "hardware/hardwareChannelBuffer.h"
 #include <stdint.h>
 #include <thread>
 
@@ -17,16 +18,22 @@ private:
     bool run_thread;
     int channel_count;
     uint8_t channel_data[512];
+    HardwareChannelBuffer channel_buffer;
+    int resend_delay;
+    int keepalive_delay;
 public:
     EnttecDMXProDevice();
     virtual ~EnttecDMXProDevice();
 
     //Configure the device.
     // Parameter: port: name of the serial port to connect to.
+    // Parameter: resend_delay: Minimal time between updates to the widget, in ms. Default 100
+    // Parameter: keepalive_delay: Time after which unchanged data is sent again, in ms. The widget keeps outputting the last data itself. Default 1000
     virtual bool configure(std::unordered_map<string, string> settings) override;
 
     //Set a hardware channel output. Value is 0.0 to 1.0 for no to max output.
     virtual void setChannelData(int channel, float value) override;
+    virtual void commitChannelData() override;
 
     //Return the number of output channels supported by this device.
     virtual int getChannelCount() override;
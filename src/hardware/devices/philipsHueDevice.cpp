@@ -14,6 +14,7 @@ PhilipsHueDevice::PhilipsHueDevice()
 {
     userfile = "philips_hue.name";
     run_thread = false;
+    light_count = 0;
 }
 
 PhilipsHueDevice::~PhilipsHueDevice()
@@ -151,6 +152,7 @@ bool PhilipsHueDevice::configure(std::unordered_map<string, string> settings)
                 }
 
                 lights.resize(light_count);
+                channel_buffer.resize(light_count * 4);
 
                 FILE* f = fopen(userfile.c_str(), "wt");
                 if (f)
@@ -180,18 +182,12 @@ bool PhilipsHueDevice::configure(std::unordered_map<string, string> settings)
 
 void PhilipsHueDevice::setChannelData(int channel, float value)
 {
-    int light_idx = channel / 4;
-    if (light_idx < 0 || light_idx >= light_count)
-        return;
+    channel_buffer.setChannel(channel, value);
+}
 
-    std::lock_guard<std::mutex> lock(mutex);
-    switch(channel % 4)
-    {
-    case 0: if (lights[light_idx].brightness != value * 254) lights[light_idx].dirty = true; lights[light_idx].brightness = value * 254; break;
-    case 1: if (lights[light_idx].saturation != value * 254) lights[light_idx].dirty = true; lights[light_idx].saturation = value * 254; break;
-    case 2: if (lights[light_idx].hue != value * 65535) lights[light_idx].dirty = true; lights[light_idx].hue = value * 65535; break;
-    case 3: if (lights[light_idx].transitiontime != value) lights[light_idx].dirty = true; lights[light_idx].transitiontime = value; break;
-    }
+void PhilipsHueDevice::commitChannelData()
+{
+    channel_buffer.publish();
 }
 
 int PhilipsHueDevice::getChannelCount()
@@ -205,20 +201,21 @@ void PhilipsHueDevice::updateLoop()
 
     while(run_thread)
     {
-        for(int n=0; n<light_count; n++)
+        if (channel_buffer.fetch())
         {
-            if (lights[n].dirty)
+            const std::vector<float>& frame = channel_buffer.getFrame();
+            for(int n=0; n<light_count; n++)
             {
-                LightInfo info;
-                {
-                    std::lock_guard<std::mutex> lock(mutex);
-                    lights[n].dirty = false;
-                    info = lights[n];
-                }
+                LightInfo& info = lights[n];
+                info.brightness = frame[n * 4 + 0] * 254;
+                info.saturation = frame[n * 4 + 1] * 254;
+                info.hue = frame[n * 4 + 2] * 65535;
+                info.transitiontime = frame[n * 4 + 3];
                 string post_data;
-                if (info.laststate != "sat-" + string(info.saturation) + "-bri-" + string(info.brightness) + "-hue-" + string(info.hue) + "-transition-" + string(info.transitiontime))
+                string state = "sat-" + string(info.saturation) + "-bri-" + string(info.brightness) + "-hue-" + string(info.hue) + "-transition-" + string(info.transitiontime);
+                if (info.laststate != state)
                 {
-                    lights[n].laststate = "sat-" + string(info.saturation) + "-bri-" + string(info.brightness) + "-hue-" + string(info.hue) + "-transition-" + string(info.transitiontime);
+                    info.laststate = state;
                     if (info.brightness > 0)
                         post_data = "{\"on\":true, \"sat\":"+string(info.saturation)+", \"bri\":"+string(info.brightness)+",\"hue\":"+string(info.hue)+", \"transitiontime\": "+string(info.transitiontime)+"}";
                     else
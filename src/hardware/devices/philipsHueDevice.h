@@ -2,10 +2,10 @@
 #define PHILIPS_HUE_DEVICE_H
 
 #include "hardware/hardwareOutputDevice.h"
+#include "hardware/hardwareChannelBuffer.h"
 
 #include <stdint.h>
 #include <thread>
-#include <mutex>
 
 //The PhilipsHueDevice talks to a philips hue bridge.
 //Documentation of the philips hue API is at:
@@ -31,6 +31,7 @@ public:
 
     //Set a hardware channel output. Value is 0.0 to 1.0 for no to max output.
     virtual void setChannelData(int channel, float value) override;
+    virtual void commitChannelData() override;
 
     //Return the number of output channels supported by this device.
     virtual int getChannelCount() override;
@@ -39,9 +40,8 @@ private:
     class LightInfo
     {
     public:
-        LightInfo() : dirty(true), brightness(0), saturation(0), hue(0), transitiontime(0), laststate(0) {}
+        LightInfo() : brightness(0), saturation(0), hue(0), transitiontime(0), laststate(0) {}
 
-        bool dirty;
         int brightness;
         int saturation;
         int hue;
@@ -50,8 +50,8 @@ private:
     };
 
     std::thread update_thread;
-    std::mutex mutex;
-    std::vector<LightInfo> lights;
+    HardwareChannelBuffer channel_buffer;
+    std::vector<LightInfo> lights;  //Only accessed from the update thread once it is running.
 
     bool run_thread;
 
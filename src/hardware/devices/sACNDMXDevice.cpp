@@ -6,14 +6,15 @@
 
 StreamingAcnDMXDevice::StreamingAcnDMXDevice()
 {
-    for(int n=0; n<512; n++)
-        channel_data[n] = 0;
     channel_count = 512;
 
     multicast = false;
+    unicast = false;
     resend_delay = 50;
+    keepalive_delay = 1000;
 
-    universe = 1;
+    sync_universe = 0;
+    sync_sequence_number = 0;
     for(int n=0; n<16; n++)
         uuid[n] = uint8_t(irandom(0, 255));
     memset(source_name, 0, sizeof(source_name));
@@ -32,23 +33,50 @@ StreamingAcnDMXDevice::~StreamingAcnDMXDevice()
 
 bool StreamingAcnDMXDevice::configure(std::unordered_map<string, string> settings)
 {
+    int first_universe = 1;
+    int universe_count = 1;
     if (settings.find("channels") != settings.end())
     {
         channel_count = std::max(1, std::min(512, settings["channels"].toInt()));
     }
     if (settings.find("universe") != settings.end())
     {
-        universe = std::max(1, std::min(63999, settings["universe"].toInt()));
+        first_universe = std::max(1, std::min(63999, settings["universe"].toInt()));
+    }
+    if (settings.find("universe_count") != settings.end())
+    {
+        universe_count = std::max(1, std::min(64, settings["universe_count"].toInt()));
+        universe_count = std::min(universe_count, 64000 - first_universe);
+    }
+    if (settings.find("sync_universe") != settings.end())
+    {
+        sync_universe = std::max(0, std::min(63999, settings["sync_universe"].toInt()));
     }
     if (settings.find("resend_delay") != settings.end())
     {
         resend_delay = std::max(1, settings["resend_delay"].toInt());
     }
+    if (settings.find("keepalive_delay") != settings.end())
+    {
+        keepalive_delay = std::max(1, settings["keepalive_delay"].toInt());
+    }
     if (settings.find("multicast") != settings.end())
     {
         multicast = settings["multicast"].toInt() != 0;
     }
+    if (settings.find("target") != settings.end())
+    {
+        target = sp::io::network::Address(settings["target"]);
+        unicast = true;
+    }
+
+    universes.resize(universe_count);
+    for(int n=0; n<universe_count; n++)
+        universes[n].number = first_universe + n;
+    buildPackets();
 
+    channel_data.assign(channel_count * universe_count, 0);
+    channel_buffer.resize(channel_count * universe_count);
     run_thread = true;
     update_thread = std::thread(&StreamingAcnDMXDevice::updateLoop, this);
     return true;
@@ -57,25 +85,32 @@ bool StreamingAcnDMXDevice::configure(std::unordered_map<string, string> setting
 //Set a hardware channel output. Value is 0.0 to 1.0 for no to max output.
 void StreamingAcnDMXDevice::setChannelData(int channel, float value)
 {
-    if (channel >= 0 && channel < channel_count)
-        channel_data[channel] = int((value * 255.0f) + 0.5f);
+    if (channel >= 0 && channel < getChannelCount())
+        channel_buffer.setChannel(channel, value);
+}
+
+void StreamingAcnDMXDevice::commitChannelData()
+{
+    channel_buffer.publish();
 }
 
 //Return the number of output channels supported by this device.
 int StreamingAcnDMXDevice::getChannelCount()
 {
-    return channel_count;
+    return channel_count * int(universes.size());
 }
 
-void StreamingAcnDMXDevice::updateLoop()
+//Build the packets once, so sending only needs to patch the sequence number and the DMX data.
+void StreamingAcnDMXDevice::buildPackets()
 {
-    uint8_t sequence_number = 0;
-    while(run_thread)
+    for(Universe& universe : universes)
     {
-        std::vector<uint8_t> buffer;
-        auto addU8 = [&buffer](uint8_t d) { buffer.resize(buffer.size() + 1); buffer[buffer.size()-1] = d; };
-        auto addU16 = [&buffer](uint16_t d) { buffer.resize(buffer.size() + 2); buffer[buffer.size()-2] = d >> 8; buffer[buffer.size()-1] = d; };
-        auto addU32 = [&buffer](uint16_t d) { buffer.resize(buffer.size() + 4); buffer[buffer.size()-4] = d >> 24; buffer[buffer.size()-3] = d >> 16; buffer[buffer.size()-2] = d >> 8; buffer[buffer.size()-1] = d; };
+        std::vector<uint8_t>& buffer = universe.packet;
+        buffer.clear();
+        buffer.reserve(data_packet_header_size + channel_count);
+        auto addU8 = [&buffer](uint8_t d) { buffer.push_back(d); };
+        auto addU16 = [&buffer](uint16_t d) { buffer.push_back(d >> 8); buffer.push_back(d); };
+        auto addU32 = [&buffer](uint32_t d) { buffer.push_back(d >> 24); buffer.push_back(d >> 16); buffer.push_back(d >> 8); buffer.push_back(d); };
 
         //Root layer
         addU16(0x0010); //RLP Size
@@ -91,10 +126,10 @@ void StreamingAcnDMXDevice::updateLoop()
         for(int n=0; n<64; n++)
             addU8(source_name[n]);//Source name, needs to be an UTF-8 zero terminated string. Only for ID goals.
         addU8(100); //Priority
-        addU16(0);  //Reserved
-        addU8(sequence_number);  //sequence number
+        addU16(sync_universe);  //Synchronization address, 0 when not synchronizing
+        addU8(0);  //sequence number
         addU8(0);  //option flags
-        addU16(universe);  //Universe number
+        addU16(universe.number);  //Universe number
         //DMP layer
         addU16(0x7000 | (11 + channel_count)); //Flags and length
         addU8(2);  //Vector, message is PDU
@@ -104,14 +139,72 @@ void StreamingAcnDMXDevice::updateLoop()
         addU16(1 + channel_count);  //Value count
         addU8(0x00); //DMX512 start byte.
         for(int n=0; n<channel_count; n++)
-            addU8(channel_data[n]);
+            addU8(0);
+
+        universe.sequence_number = 0;
+        universe.last_send = std::chrono::steady_clock::time_point();
+    }
+
+    //Universe synchronization packet
+    uint8_t* p = sync_packet;
+    auto addU8 = [&p](uint8_t d) { *p++ = d; };
+    auto addU16 = [&p](uint16_t d) { *p++ = d >> 8; *p++ = d; };
+    auto addU32 = [&p](uint32_t d) { *p++ = d >> 24; *p++ = d >> 16; *p++ = d >> 8; *p++ = d; };
+    //Root layer
+    addU16(0x0010); //RLP Size
+    addU16(0x0000); //RLP Preamble size
+    addU8('A'); addU8('S'); addU8('C'); addU8('-'); addU8('E'); addU8('1'); addU8('.'); addU8('1'); addU8('7'); addU8('\0'); addU8('\0'); addU8('\0'); //ACN Packet identifier
+    addU16(0x7000 | (sync_packet_size - 16)); //Flags and length
+    addU32(0x0008); //Vector, identifies as extended E1.31 packet
+    for(int n=0; n<16; n++)
+        addU8(uuid[n]);
+    //Framing layer
+    addU16(0x7000 | (sync_packet_size - 38)); //Flags and length
+    addU32(0x0001); //Vector, identifies as synchronization packet
+    addU8(0);  //sequence number
+    addU16(sync_universe);  //Synchronization address
+    addU16(0);  //Reserved
+}
+
+void StreamingAcnDMXDevice::send(const uint8_t* data, size_t size, int universe)
+{
+    if (unicast)
+        socket.send(data, size, target, acn_port);
+    else if (multicast)
+        socket.sendMulticast(data, size, universe, acn_port);
+    else
+        socket.sendBroadcast(data, size, acn_port);
+}
+
+void StreamingAcnDMXDevice::updateLoop()
+{
+    while(run_thread)
+    {
+        bool changed = channel_buffer.fetchDMX(channel_data.data());
+        auto now = std::chrono::steady_clock::now();
+        bool sent = false;
+        for(unsigned int n=0; n<universes.size(); n++)
+        {
+            Universe& universe = universes[n];
+            uint8_t* payload = universe.packet.data() + data_packet_header_size;
+            const uint8_t* data = channel_data.data() + n * channel_count;
 
-        sequence_number++;
+            //Only send when the channel data changed, or as keepalive so receivers do not consider the source lost.
+            bool universe_changed = changed && memcmp(payload, data, channel_count) != 0;
+            if (!universe_changed && now - universe.last_send < std::chrono::milliseconds(keepalive_delay))
+                continue;
 
-        if (multicast)
-            socket.sendMulticast(buffer.data(), buffer.size(), universe, acn_port);
-        else
-            socket.sendBroadcast(buffer.data(), buffer.size(), acn_port);
+            memcpy(payload, data, channel_count);
+            universe.packet[sequence_number_offset] = universe.sequence_number++;
+            send(universe.packet.data(), universe.packet.size(), universe.number);
+            universe.last_send = now;
+            sent = true;
+        }
+        if (sent && sync_universe > 0)
+        {
+            sync_packet[sync_sequence_number_offset] = sync_sequence_number++;
+            send(sync_packet, sync_packet_size, sync_universe);
+        }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(resend_delay));
     }
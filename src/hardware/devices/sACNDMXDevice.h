@@ -2,10 +2,14 @@
 #define S_ACN_DMX_DEVICE_H
 
 #include <io/network/udpSocket.h>
+#include <io/network/address.h>
 #include "hardware/hardwareOutputDevice.h"
+#include "hardware/hardwareChannelBuffer.h"
 
 #include <stdint.h>
 #include <thread>
+#include <chrono>
+#include <vector>
 
 //The AcnDMXDevice talks the ACN E1.31 protocol. Which is an UDP protocol for sending DMX messages trough IP networks.
 class StreamingAcnDMXDevice : public HardwareOutputDevice
@@ -13,17 +17,40 @@ class StreamingAcnDMXDevice : public HardwareOutputDevice
 private:
     static constexpr int acn_port = 5568;
 
+    //Offsets into the E1.31 data packet, which are patched before each send.
+    static constexpr int data_packet_header_size = 126;
+    static constexpr int sequence_number_offset = 111;
+    static constexpr int sync_packet_size = 49;
+    static constexpr int sync_sequence_number_offset = 44;
+
+    class Universe
+    {
+    public:
+        int number;
+        uint8_t sequence_number;
+        std::vector<uint8_t> packet;    //Complete E1.31 data packet, only the sequence number and the DMX data change between sends.
+        std::chrono::steady_clock::time_point last_send;
+    };
+
     std::thread update_thread;
     sp::io::network::UdpSocket socket;
 
     bool run_thread;
-    int channel_count;
-    uint8_t channel_data[512];
+    int channel_count;              //Channels per universe
+    std::vector<uint8_t> channel_data;
+    HardwareChannelBuffer channel_buffer;
 
     int resend_delay;
+    int keepalive_delay;
     bool multicast;
+    sp::io::network::Address target;
+    bool unicast;
+
+    std::vector<Universe> universes;
+    int sync_universe;
+    uint8_t sync_sequence_number;
+    uint8_t sync_packet[sync_packet_size];
 
-    int universe;
     uint8_t uuid[16];
     uint8_t source_name[64];
 public:
@@ -31,19 +58,26 @@ public:
     virtual ~StreamingAcnDMXDevice();
 
     //Configure the device.
-    // Parameter: "channels" amount of output channels used (default: 512)
+    // Parameter: "channels" amount of output channels used per universe (default: 512)
     // Parameter: "universe" which sACN universe to broadcast in. Default "1"
-    // Parameter: "resend_delay" Time between broadcast packets, in ms. Default "50"
+    // Parameter: "universe_count" amount of consecutive universes to send, starting at "universe". The device has channels x universe_count output channels. Default "1"
+    // Parameter: "sync_universe" when set, receivers are asked to hold the data until a synchronization packet is sent on this universe after each update. Default "0" (no synchronization)
+    // Parameter: "resend_delay" Minimal time between broadcast packets, in ms. Default "50"
+    // Parameter: "keepalive_delay" Time after which unchanged data is sent again, in ms. Default "1000"
     // Parameter: "multicast" Per default, sACN should be using multicast. But this implementation can also use broadcast. Default is to use broadcast. Set to 1 for multicast.
+    // Parameter: "target" send unicast packets to this address instead of broadcast or multicast.
     virtual bool configure(std::unordered_map<string, string> settings) override;
 
     //Set a hardware channel output. Value is 0.0 to 1.0 for no to max output.
     virtual void setChannelData(int channel, float value) override;
+    virtual void commitChannelData() override;
 
     //Return the number of output channels supported by this device.
     virtual int getChannelCount() override;
 
 private:
+    void buildPackets();
+    void send(const uint8_t* data, size_t size, int universe);
     void updateLoop();
 };
 
@@ -0,0 +1,63 @@
+#include "hardwareChannelBuffer.h"
+
+HardwareChannelBuffer::HardwareChannelBuffer()
+: staging_changed(false), back_index(0), front_index(1), middle(2)
+{
+}
+
+void HardwareChannelBuffer::resize(int channel_count)
+{
+    staging.assign(channel_count, 0.0f);
+    for(int n=0; n<3; n++)
+        buffers[n].assign(channel_count, 0.0f);
+    staging_changed = true;
+}
+
+void HardwareChannelBuffer::setChannel(int channel, float value)
+{
+    if (channel < 0 || channel >= int(staging.size()))
+        return;
+    if (staging[channel] != value)
+    {
+        staging[channel] = value;
+        staging_changed = true;
+    }
+}
+
+void HardwareChannelBuffer::publish()
+{
+    if (!staging_changed)
+        return;
+    staging_changed = false;
+
+    //The back buffer is owned by the producer, so it can be filled without synchronization.
+    //Swapping it with the middle buffer hands it to the consumer.
+    buffers[back_index] = staging;
+    back_index = middle.exchange(uint8_t(back_index) | fresh_flag, std::memory_order_acq_rel) & index_mask;
+}
+
+bool HardwareChannelBuffer::fetch()
+{
+    if (!(middle.load(std::memory_order_acquire) & fresh_flag))
+        return false;
+    front_index = middle.exchange(uint8_t(front_index), std::memory_order_acq_rel) & index_mask;
+    return true;
+}
+
+bool HardwareChannelBuffer::fetchDMX(uint8_t* data)
+{
+    if (!fetch())
+        return false;
+    bool changed = false;
+    const std::vector<float>& frame = buffers[front_index];
+    for(unsigned int n=0; n<frame.size(); n++)
+    {
+        uint8_t value = int((frame[n] * 255.0f) + 0.5f);
+        if (data[n] != value)
+        {
+            data[n] = value;
+            changed = true;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,44 @@
+#ifndef HARDWARE_CHANNEL_BUFFER_H
+#define HARDWARE_CHANNEL_BUFFER_H
+
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+
+//Triple buffer to pass channel frames from the main thread to the update thread of an output device.
+//The main thread sets channels and publishes the frame, the device thread fetches the latest published frame.
+//Neither side ever blocks, and the device thread always sees a complete frame.
+//Only a single producer thread and a single consumer thread are supported.
+class HardwareChannelBuffer
+{
+public:
+    HardwareChannelBuffer();
+
+    //Set the amount of channels. Must be called before the device thread is started.
+    void resize(int channel_count);
+
+    //Producer side, called from the main thread.
+    void setChannel(int channel, float value);
+    //Make the channels set since the previous publish available to the consumer, if any changed.
+    void publish();
+
+    //Consumer side, called from the device thread. Returns true when a new frame was published since the previous fetch.
+    bool fetch();
+    //Fetch a new frame and convert it to DMX values (0-255) into data, which needs room for all channels. Returns true when any DMX value changed.
+    bool fetchDMX(uint8_t* data);
+    //Channel data of the last fetched frame.
+    const std::vector<float>& getFrame() const { return buffers[front_index]; }
+
+private:
+    static constexpr uint8_t fresh_flag = 0x04;
+    static constexpr uint8_t index_mask = 0x03;
+
+    std::vector<float> staging;
+    bool staging_changed;
+    std::vector<float> buffers[3];
+    int back_index;
+    int front_index;
+    std::atomic<uint8_t> middle;    //Index of the buffer in between producer and consumer, with fresh_flag set when it was published but not fetched yet.
+};
+
+#endif//HARDWARE_CHANNEL_BUFFER_H
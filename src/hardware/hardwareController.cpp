@@ -186,36 +186,38 @@ void HardwareController::update(float delta)
 {
     if (channels.size() < 1)
         return;
-    for(float& value : channels)
-        value = 0.0;
-    for(HardwareMappingState& state : states)
+    ship = my_spaceship;
+    if (!ship && gameGlobalInfo)
+        ship = gameGlobalInfo->getPlayerShip(0);
+
+    if (channel_dirty.size() != channels.size())
     {
-        float value;
-        bool active = false;
-        if (getVariableValue(state.variable, value))
-        {
-            switch(state.compare_operator)
-            {
-            case HardwareMappingState::Less: active = value < state.compare_value; break;
-            case HardwareMappingState::Greater: active = value > state.compare_value; break;
-            case HardwareMappingState::Equal: active = value == state.compare_value; break;
-            case HardwareMappingState::NotEqual: active = value != state.compare_value; break;
-            }
-        }
+        channel_dirty.assign(channels.size(), true);
+        sent_channels.assign(channels.size(), 0.0);
+        first_update = true;
+    }
 
-        if (active && state.channel_nr < int(channels.size()))
-        {
-            channels[state.channel_nr] = state.effect->onActive();
-        }else{
-            state.effect->onInactive();
-        }
+    for(VariableSlot& slot : variable_slots)
+    {
+        float value = 0.0;
+        bool valid = getVariableValue(slot.variable, value);
+        slot.changed = first_update || valid != slot.valid || value != slot.value;
+        slot.value = value;
+        slot.valid = valid;
+    }
+
+    for(HardwareMappingState& state : states)
+    {
+        if (state.channel_nr < int(channels.size()) && (variable_slots[state.variable_slot].changed || state.effect->isAnimated()))
+            channel_dirty[state.channel_nr] = true;
     }
     for(HardwareMappingEvent& event : events)
     {
-        float value;
+        const VariableSlot& slot = variable_slots[event.trigger_variable_slot];
         bool trigger = false;
-        if (getVariableValue(event.trigger_variable, value))
+        if (slot.valid)
         {
+            float value = slot.value;
             if (event.previous_valid)
             {
                 switch(event.compare_operator)
@@ -243,7 +245,47 @@ void HardwareController::update(float delta)
         {
             event.timer.start(event.runtime);
         }
-        if (event.timer.isRunning() && event.channel_nr < int(channels.size()))
+        bool running = event.timer.isRunning();
+        if ((running || event.was_running) && event.channel_nr < int(channels.size()))
+            channel_dirty[event.channel_nr] = true;
+        event.was_running = running;
+    }
+    first_update = false;
+
+    for(unsigned int n=0; n<channels.size(); n++)
+    {
+        if (channel_dirty[n])
+            channels[n] = 0.0;
+    }
+    for(HardwareMappingState& state : states)
+    {
+        if (state.channel_nr >= int(channels.size()) || !channel_dirty[state.channel_nr])
+            continue;
+        const VariableSlot& slot = variable_slots[state.variable_slot];
+        bool active = false;
+        if (slot.valid)
+        {
+            switch(state.compare_operator)
+            {
+            case HardwareMappingState::Less: active = slot.value < state.compare_value; break;
+            case HardwareMappingState::Greater: active = slot.value > state.compare_value; break;
+            case HardwareMappingState::Equal: active = slot.value == state.compare_value; break;
+            case HardwareMappingState::NotEqual: active = slot.value != state.compare_value; break;
+            }
+        }
+
+        if (active)
+        {
+            channels[state.channel_nr] = state.effect->onActive();
+        }else{
+            state.effect->onInactive();
+        }
+    }
+    for(HardwareMappingEvent& event : events)
+    {
+        if (event.channel_nr >= int(channels.size()) || !channel_dirty[event.channel_nr])
+            continue;
+        if (event.timer.isRunning())
         {
             channels[event.channel_nr] = event.effect->onActive();
             event.timer.isExpired(); //reset the running state if it is expired.
@@ -252,11 +294,20 @@ void HardwareController::update(float delta)
         }
     }
 
+    //Only pass changed channels to the devices, so they know when there is something new to send.
     int idx = 0;
     for(HardwareOutputDevice* device : devices)
     {
-        for(int n=0; n<device->getChannelCount(); n++)
-            device->setChannelData(n, channels[idx++]);
+        for(int n=0; n<device->getChannelCount(); n++, idx++)
+        {
+            if (channel_dirty[idx] && channels[idx] != sent_channels[idx])
+            {
+                device->setChannelData(n, channels[idx]);
+                sent_channels[idx] = channels[idx];
+            }
+            channel_dirty[idx] = false;
+        }
+        device->commitChannelData();
     }
 }
 
@@ -265,7 +316,7 @@ void HardwareController::createNewHardwareMappingState(int channel_number, std::
     string condition = settings["condition"];
 
     HardwareMappingState state;
-    state.variable = condition;
+    string variable_name = condition;
     state.compare_operator = HardwareMappingState::Greater;
     state.compare_value = 0.0;
     state.channel_nr = channel_number;
@@ -282,17 +333,22 @@ void HardwareController::createNewHardwareMappingState(int channel_number, std::
         }
         if (condition.find(compare_string) > -1)
         {
-            state.variable = condition.substr(0, condition.find(compare_string)).strip();
+            variable_name = condition.substr(0, condition.find(compare_string)).strip();
             state.compare_operator = compare_operator;
             state.compare_value = condition.substr(condition.find(compare_string) + 1).strip().toFloat();
         }
     }
 
+    HardwareVariable variable = resolveVariable(variable_name);
+    if (!variable.isValid())
+        return;
+    state.variable_slot = getVariableSlot(variable);
+
     state.effect = createEffect(settings);
 
     if (state.effect)
     {
-        LOG(DEBUG) << "New hardware state: " << state.channel_nr << ":" << state.variable << " " << state.compare_operator << " " << state.compare_value;
+        LOG(DEBUG) << "New hardware state: " << state.channel_nr << ":" << variable_name << " " << state.compare_operator << " " << state.compare_value;
         states.push_back(state);
     }
 }
@@ -313,7 +369,11 @@ void HardwareController::createNewHardwareMappingEvent(int channel_number, std::
         event.compare_operator = HardwareMappingEvent::Increase;
         trigger = trigger.substr(1).strip();
     }
-    event.trigger_variable = trigger;
+    HardwareVariable variable = resolveVariable(trigger);
+    if (!variable.isValid())
+        return;
+    event.trigger_variable_slot = getVariableSlot(variable);
+    event.was_running = false;
     event.channel_nr = channel_number;
     event.runtime = settings["runtime"].toFloat();
     event.previous_value = 0.0;
@@ -321,7 +381,7 @@ void HardwareController::createNewHardwareMappingEvent(int channel_number, std::
     event.effect = createEffect(settings);
     if (event.effect)
     {
-        LOG(DEBUG) << "New hardware event: " << event.channel_nr << ":" << event.trigger_variable << " " << event.compare_operator;
+        LOG(DEBUG) << "New hardware event: " << event.channel_nr << ":" << trigger << " " << event.compare_operator;
         events.push_back(event);
     }
 }
@@ -347,64 +407,127 @@ HardwareMappingEffect* HardwareController::createEffect(std::unordered_map<strin
     return nullptr;
 }
 
-#define SHIP_VARIABLE(name, formula) if (variable_name == name) { if (ship) { value = (formula); return true; } return false; }
-bool HardwareController::getVariableValue(string variable_name, float& value)
+int HardwareController::getVariableSlot(const HardwareVariable& variable)
 {
-    P<PlayerSpaceship> ship = my_spaceship;
-    if (!ship && gameGlobalInfo)
-        ship = gameGlobalInfo->getPlayerShip(0);
+    for(unsigned int n=0; n<variable_slots.size(); n++)
+        if (variable_slots[n].variable == variable)
+            return n;
+    VariableSlot slot;
+    slot.variable = variable;
+    slot.value = 0.0;
+    slot.valid = false;
+    slot.changed = true;
+    variable_slots.push_back(slot);
+    return variable_slots.size() - 1;
+}
 
-    if (variable_name == "Always")
+HardwareVariable HardwareController::resolveVariable(string variable_name)
+{
+    static std::unordered_map<string, HardwareVariable> variables;
+    if (variables.empty())
     {
-        value = 1.0;
-        return true;
+        auto add = [](string name, HardwareVariable::EType type, int index)
+        {
+            HardwareVariable variable;
+            variable.type = type;
+            variable.index = index;
+            variables[name] = variable;
+        };
+        add("Always", HardwareVariable::Always, 0);
+        add("HasShip", HardwareVariable::HasShip, 0);
+        add("Hull", HardwareVariable::Hull, 0);
+        add("FrontShield", HardwareVariable::Shield, 0);
+        add("RearShield", HardwareVariable::Shield, 1);
+        for(int n=0; n<8; n++)
+            add("Shield" + string(n), HardwareVariable::Shield, n);
+        add("Energy", HardwareVariable::Energy, 0);
+        add("ShieldsUp", HardwareVariable::ShieldsUp, 0);
+        add("Impulse", HardwareVariable::Impulse, 0);
+        add("Warp", HardwareVariable::Warp, 0);
+        add("Docking", HardwareVariable::Docking, 0);
+        add("Docked", HardwareVariable::Docked, 0);
+        add("InNebula", HardwareVariable::InNebula, 0);
+        add("IsJammed", HardwareVariable::IsJammed, 0);
+        add("Jumping", HardwareVariable::Jumping, 0);
+        add("Jumped", HardwareVariable::Jumped, 0);
+        add("Alert", HardwareVariable::Alert, 0);
+        add("YellowAlert", HardwareVariable::YellowAlert, 0);
+        add("RedAlert", HardwareVariable::RedAlert, 0);
+        for(int n=0; n<max_weapon_tubes; n++)
+        {
+            add("TubeLoaded" + string(n), HardwareVariable::TubeLoaded, n);
+            add("TubeLoading" + string(n), HardwareVariable::TubeLoading, n);
+            add("TubeUnloading" + string(n), HardwareVariable::TubeUnloading, n);
+            add("TubeFiring" + string(n), HardwareVariable::TubeFiring, n);
+        }
+        for(int n=0; n<SYS_COUNT; n++)
+        {
+            string system_name = getSystemName(ESystem(n)).replace(" ", "");
+            add(system_name + "Health", HardwareVariable::SystemHealth, n);
+            add(system_name + "Power", HardwareVariable::SystemPower, n);
+            add(system_name + "Heat", HardwareVariable::SystemHeat, n);
+            add(system_name + "Coolant", HardwareVariable::SystemCoolant, n);
+            add(system_name + "Hacked", HardwareVariable::SystemHacked, n);
+        }
     }
-    if (variable_name == "HasShip")
+
+    auto it = variables.find(variable_name);
+    if (it == variables.end())
     {
-        value = bool(ship) ? 1.0f : 0.0f;
-        return true;
+        LOG(ERROR) << "Unknown variable in hardware.ini: " << variable_name;
+        return HardwareVariable();
     }
-    SHIP_VARIABLE("Hull", 100.0f * ship->hull_strength / ship->hull_max);
-    SHIP_VARIABLE("FrontShield", ship->getShieldPercentage(0));
-    SHIP_VARIABLE("RearShield", ship->getShieldPercentage(1));
-    SHIP_VARIABLE("Shield0", ship->getShieldPercentage(0));
-    SHIP_VARIABLE("Shield1", ship->getShieldPercentage(1));
-    SHIP_VARIABLE("Shield2", ship->getShieldPercentage(2));
-    SHIP_VARIABLE("Shield3", ship->getShieldPercentage(3));
-    SHIP_VARIABLE("Shield4", ship->getShieldPercentage(4));
-    SHIP_VARIABLE("Shield5", ship->getShieldPercentage(5));
-    SHIP_VARIABLE("Shield6", ship->getShieldPercentage(6));
-    SHIP_VARIABLE("Shield7", ship->getShieldPercentage(7));
-    SHIP_VARIABLE("Energy", ship->energy_level * 100 / ship->max_energy_level);
-    SHIP_VARIABLE("ShieldsUp", ship->shields_active ? 1.0f : 0.0f);
-    SHIP_VARIABLE("Impulse", ship->current_impulse * ship->getSystemEffectiveness(SYS_Impulse));
-    SHIP_VARIABLE("Warp", ship->current_warp * ship->getSystemEffectiveness(SYS_Warp));
-    SHIP_VARIABLE("Docking", ship->docking_state == DS_Docking ? 1.0f : 0.0f);
-    SHIP_VARIABLE("Docked", ship->docking_state == DS_Docked ? 1.0f : 0.0f);
-    SHIP_VARIABLE("InNebula", Nebula::inNebula(ship->getPosition()) ? 1.0f : 0.0f);
-    SHIP_VARIABLE("IsJammed", WarpJammer::isWarpJammed(ship->getPosition()) ? 1.0f : 0.0f);
-    SHIP_VARIABLE("Jumping", ship->jump_delay > 0.0f ? 1.0f : 0.0f);
-    SHIP_VARIABLE("Jumped", ship->jump_indicator > 0.0f ? 1.0f : 0.0f);
-    SHIP_VARIABLE("Alert", ship->getAlertLevel() != AL_Normal ? 1.0f : 0.0f);
-    SHIP_VARIABLE("YellowAlert", ship->getAlertLevel() == AL_YellowAlert ? 1.0f : 0.0f);
-    SHIP_VARIABLE("RedAlert", ship->getAlertLevel() == AL_RedAlert ? 1.0f : 0.0f);
-    for(int n=0; n<max_weapon_tubes; n++)
+    return it->second;
+}
+
+bool HardwareController::getVariableValue(const HardwareVariable& variable, float& value)
+{
+    switch(variable.type)
     {
-        SHIP_VARIABLE("TubeLoaded" + string(n), ship->weapon_tube[n].isLoaded() ? 1.0f : 0.0f);
-        SHIP_VARIABLE("TubeLoading" + string(n), ship->weapon_tube[n].isLoading() ? 1.0f : 0.0f);
-        SHIP_VARIABLE("TubeUnloading" + string(n), ship->weapon_tube[n].isUnloading() ? 1.0f : 0.0f);
-        SHIP_VARIABLE("TubeFiring" + string(n), ship->weapon_tube[n].isFiring() ? 1.0f : 0.0f);
+    case HardwareVariable::Invalid:
+        value = 0.0;
+        return false;
+    case HardwareVariable::Always:
+        value = 1.0;
+        return true;
+    case HardwareVariable::HasShip:
+        value = bool(ship) ? 1.0f : 0.0f;
+        return true;
+    default:
+        break;
     }
-    for(int n=0; n<SYS_COUNT; n++)
+    if (!ship)
+        return false;
+
+    switch(variable.type)
     {
-        SHIP_VARIABLE(getSystemName(ESystem(n)).replace(" ", "") + "Health", ship->systems[n].health);
-        SHIP_VARIABLE(getSystemName(ESystem(n)).replace(" ", "") + "Power", ship->systems[n].power_level / 3.0f);
-        SHIP_VARIABLE(getSystemName(ESystem(n)).replace(" ", "") + "Heat", ship->systems[n].heat_level);
-        SHIP_VARIABLE(getSystemName(ESystem(n)).replace(" ", "") + "Coolant", ship->systems[n].coolant_level);
-        SHIP_VARIABLE(getSystemName(ESystem(n)).replace(" ", "") + "Hacked", ship->systems[n].hacked_level);
+    case HardwareVariable::Hull: value = 100.0f * ship->hull_strength / ship->hull_max; break;
+    case HardwareVariable::Shield: value = ship->getShieldPercentage(variable.index); break;
+    case HardwareVariable::Energy: value = ship->energy_level * 100 / ship->max_energy_level; break;
+    case HardwareVariable::ShieldsUp: value = ship->shields_active ? 1.0f : 0.0f; break;
+    case HardwareVariable::Impulse: value = ship->current_impulse * ship->getSystemEffectiveness(SYS_Impulse); break;
+    case HardwareVariable::Warp: value = ship->current_warp * ship->getSystemEffectiveness(SYS_Warp); break;
+    case HardwareVariable::Docking: value = ship->docking_state == DS_Docking ? 1.0f : 0.0f; break;
+    case HardwareVariable::Docked: value = ship->docking_state == DS_Docked ? 1.0f : 0.0f; break;
+    case HardwareVariable::InNebula: value = Nebula::inNebula(ship->getPosition()) ? 1.0f : 0.0f; break;
+    case HardwareVariable::IsJammed: value = WarpJammer::isWarpJammed(ship->getPosition()) ? 1.0f : 0.0f; break;
+    case HardwareVariable::Jumping: value = ship->jump_delay > 0.0f ? 1.0f : 0.0f; break;
+    case HardwareVariable::Jumped: value = ship->jump_indicator > 0.0f ? 1.0f : 0.0f; break;
+    case HardwareVariable::Alert: value = ship->getAlertLevel() != AL_Normal ? 1.0f : 0.0f; break;
+    case HardwareVariable::YellowAlert: value = ship->getAlertLevel() == AL_YellowAlert ? 1.0f : 0.0f; break;
+    case HardwareVariable::RedAlert: value = ship->getAlertLevel() == AL_RedAlert ? 1.0f : 0.0f; break;
+    case HardwareVariable::TubeLoaded: value = ship->weapon_tube[variable.index].isLoaded() ? 1.0f : 0.0f; break;
+    case HardwareVariable::TubeLoading: value = ship->weapon_tube[variable.index].isLoading() ? 1.0f : 0.0f; break;
+    case HardwareVariable::TubeUnloading: value = ship->weapon_tube[variable.index].isUnloading() ? 1.0f : 0.0f; break;
+    case HardwareVariable::TubeFiring: value = ship->weapon_tube[variable.index].isFiring() ? 1.0f : 0.0f; break;
+    case HardwareVariable::SystemHealth: value = ship->systems[variable.index].health; break;
+    case HardwareVariable::SystemPower: value = ship->systems[variable.index].power_level / 3.0f; break;
+    case HardwareVariable::SystemHeat: value = ship->systems[variable.index].heat_level; break;
+    case HardwareVariable::SystemCoolant: value = ship->systems[variable.index].coolant_level; break;
+    case HardwareVariable::SystemHacked: value = ship->systems[variable.index].hacked_level; break;
+    default:
+        value = 0.0;
+        return false;
     }
-
-    LOG(WARNING) << "Unknown variable: " << variable_name;
-    value = 0.0;
-    return false;
+    return true;
 }
@@ -5,10 +5,52 @@
 #include "hardwareOutputDevice.h"
 #include "timer.h"
 #include "Updatable.h"
+#include "spaceObjects/playerSpaceship.h"
 
 
 class HardwareOutputDevice;
 class HardwareMappingEffect;
+//Variable from the hardware configuration, resolved from its name once when the configuration is loaded.
+class HardwareVariable
+{
+public:
+    enum EType
+    {
+        Invalid,
+        Always,
+        HasShip,
+        Hull,
+        Shield,
+        Energy,
+        ShieldsUp,
+        Impulse,
+        Warp,
+        Docking,
+        Docked,
+        InNebula,
+        IsJammed,
+        Jumping,
+        Jumped,
+        Alert,
+        YellowAlert,
+        RedAlert,
+        TubeLoaded,
+        TubeLoading,
+        TubeUnloading,
+        TubeFiring,
+        SystemHealth,
+        SystemPower,
+        SystemHeat,
+        SystemCoolant,
+        SystemHacked
+    };
+
+    EType type = Invalid;
+    int index = 0;  //Shield, tube or system index, for the variables that need one.
+
+    bool isValid() const { return type != Invalid; }
+    bool operator==(const HardwareVariable& other) const { return type == other.type && index == other.index; }
+};
 class HardwareMappingState
 {
 public:
@@ -20,7 +62,7 @@ public:
         NotEqual
     };
 
-    string variable;
+    int variable_slot;
     EOperator compare_operator;
     float compare_value;
     int channel_nr;
@@ -37,9 +79,10 @@ public:
         Decrease
     };
 
-    string trigger_variable;
+    int trigger_variable_slot;
     float runtime;
     sp::Timer timer;
+    bool was_running;
 
     EOperator compare_operator;
     bool previous_valid;
@@ -56,6 +99,21 @@ private:
     std::vector<HardwareMappingState> states;
     std::vector<HardwareMappingEvent> events;
     std::vector<float> channels;
+    std::vector<float> sent_channels;
+    std::vector<bool> channel_dirty;
+    P<PlayerSpaceship> ship;
+
+    //Every distinct variable used by a state or event is evaluated once per update.
+    //Channels are only recomputed when one of their variables changed or an effect on them is animated.
+    struct VariableSlot
+    {
+        HardwareVariable variable;
+        float value;
+        bool valid;
+        bool changed;
+    };
+    std::vector<VariableSlot> variable_slots;
+    bool first_update = true;
 public:
     HardwareController() = default;
     ~HardwareController();
@@ -64,12 +122,15 @@ public:
 
     virtual void update(float delta) override;
 
-    bool getVariableValue(string variable_name, float& value);
+    //Resolve a variable name from the configuration. Returns an invalid variable and logs an error for unknown names.
+    static HardwareVariable resolveVariable(string variable_name);
+    bool getVariableValue(const HardwareVariable& variable, float& value);
 private:
     void handleConfig(string section, std::unordered_map<string, string>& settings);
     void createNewHardwareMappingState(int channel_number, std::unordered_map<string, string>& settings);
     void createNewHardwareMappingEvent(int channel_number, std::unordered_map<string, string>& settings);
     HardwareMappingEffect* createEffect(std::unordered_map<string, string>& settings);
+    int getVariableSlot(const HardwareVariable& variable);
 };
 
 #endif//HARDWARE_CONTROLLER_H
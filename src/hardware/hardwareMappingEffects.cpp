@@ -93,6 +93,7 @@ HardwareMappingEffectVariable::HardwareMappingEffectVariable(HardwareController*
 
 bool HardwareMappingEffectVariable::configure(std::unordered_map<string, string> settings)
 {
+    string variable_name;
     if (settings.find("condition") != settings.end())
     {
         variable_name = settings["condition"];
@@ -121,13 +122,16 @@ bool HardwareMappingEffectVariable::configure(std::unordered_map<string, string>
     OPT_SETTING("max_input", max_input, "value", 1.0);
     OPT_SETTING("min_output", min_output, "value", 0.0);
     OPT_SETTING("max_output", max_output, "value", 1.0);
-    return variable_name != "";
+    if (variable_name == "")
+        return false;
+    variable = HardwareController::resolveVariable(variable_name);
+    return variable.isValid();
 }
 
 float HardwareMappingEffectVariable::onActive()
 {
     float input = 0.0;
-    controller->getVariableValue(variable_name, input);
+    controller->getVariableValue(variable, input);
     input = std::min(max_input, std::max(min_input, input));
     return Tween<float>::linear(input, min_input, max_input, min_output, max_output);
 }
@@ -4,8 +4,7 @@
 #include <unordered_map>
 #include "stringImproved.h"
 #include "timer.h"
-
-class HardwareController;
+#include "hardwareController.h"
 
 class HardwareMappingEffect
 {
@@ -17,6 +16,8 @@ public:
 
     virtual float onActive() = 0;
     virtual void onInactive() {}
+    //Animated effects change their output over time, so channels using them are recomputed every update.
+    virtual bool isAnimated() { return true; }
 
 protected:
     static float convertOutput(string number);
@@ -29,6 +30,7 @@ private:
 public:
     virtual bool configure(std::unordered_map<string, string> settings) override;
     virtual float onActive() override;
+    virtual bool isAnimated() override { return false; }
 };
 
 class HardwareMappingEffectGlow : public HardwareMappingEffect
@@ -61,7 +63,7 @@ class HardwareMappingEffectVariable : public HardwareMappingEffect
 {
 private:
     HardwareController* controller;
-    string variable_name;
+    HardwareVariable variable;
     float min_input, max_input;
     float min_output, max_output;
 public:
@@ -15,6 +15,9 @@ public:
     //Set a hardware channel output. Value is 0.0 to 1.0 for no to max output.
     virtual void setChannelData(int channel, float value) = 0;
 
+    //Called after all channels for this update have been set. Devices with their own update thread hand over the new frame here.
+    virtual void commitChannelData() {}
+
     //Return the number of output channels supported by this device.
     virtual int getChannelCount() = 0;
 };
@@ -1,8 +1,24 @@
 #include "httpScriptAccess.h"
 #include "gameGlobalInfo.h"
+#include "replicationProfiler.h"
+
+#include <algorithm>
 
 #define sOBJECT "_OBJECT_"
+#define sOBJECTS "_OBJECTS_"
+#define sRATE "_RATE_"
 
+// Build a key from the query parameters that does not depend on the order of the parameters.
+// Each component is prefixed with its length, so values containing separators cannot collide with other queries.
+static string normalizedQuery(const string& endpoint, const std::unordered_map<string, string>& query)
+{
+    std::vector<std::pair<string, string>> parameters(query.begin(), query.end());
+    std::sort(parameters.begin(), parameters.end());
+    string key = endpoint;
+    for(auto& parameter : parameters)
+        key += "&" + string(int(parameter.first.length())) + ":" + parameter.first + string(int(parameter.second.length())) + ":" + parameter.second;
+    return key;
+}
 
 EEHttpServer::EEHttpServer(int port, string static_file_path)
 : server(port)
@@ -22,7 +38,12 @@ EEHttpServer::EEHttpServer(int port, string static_file_path)
         script->destroy();
         return output;
     });
-    server.addURLHandler("/get.lua", [](const sp::io::http::Server::Request& request) -> string
+    server.addURLHandler("/replication.json", [](const sp::io::http::Server::Request& request) -> string
+    {
+        // Estimated replication traffic per object type and member, see ReplicationProfiler.
+        return ReplicationProfiler::getReportJSON();
+    });
+    server.addURLHandler("/get.lua", [this](const sp::io::http::Server::Request& request) -> string
     {
         /*
         Call LUA-exposed functions and return their result in a dictionary.
@@ -45,50 +66,140 @@ EEHttpServer::EEHttpServer(int port, string static_file_path)
             return "{\"ERROR\": \"No game\"}";
         }
 
-        string luaCode;
-        string objectId = "getPlayerShip(-1)";
         std::unordered_map<string, string>::const_iterator i;
-        P<ScriptObject> script;
+        for (i = request.query.begin(); i != request.query.end(); i++)
+        {
+            if (i->first == sOBJECT)
+                continue;
+            // Fail if trying to set stuff. We only do get.
+            if (i->second.substr(0, 3) == "set")
+            {
+                return "{\"ERROR\": \"Cannot set values through get.lua\", \"COMMAND\": \"" + i->second + "\"}";
+            }
+        }
+
         string output;
+        bool success = runQuery(normalizedQuery("get", request.query), [&request]()
+        {
+            string luaCode;
+            string objectId = "getPlayerShip(-1)";
+
+            // Look for _OBJECT_ in parameters. If not found, use default
+            auto i = request.query.find(sOBJECT);
+            if (i != request.query.end())
+            {
+                objectId = i->second;
+            }
 
-        // Look for _OBJECT_ in parameters. If not found, use default
-        i = request.query.find(sOBJECT);
-        if (i != request.query.end())
+            luaCode = "local object = " + objectId + "\n" +
+                      "if object == nil then return {error = \"No valid object\"} end\n" +
+                      "return {";
+
+            // Loop through URL parameters
+            for (i = request.query.begin(); i != request.query.end(); i++)
+            {
+                if (i->first == sOBJECT)
+                    continue;
+                // Build LUA-code
+                luaCode += i->first + " = object:" + i->second + ", ";
+            }   luaCode += "}";
+            return luaCode;
+        }, output);
+
+        // Return dictionary with error, else output
+        if (!success)
         {
-            objectId = i->second;
+            output = "{\"ERROR\": \"Script error\"}";
         }
+        return output;
+    });
+    server.addURLHandler("/getmulti.lua", [this](const sp::io::http::Server::Request& request) -> string
+    {
+        /*
+        Call LUA-exposed functions on multiple objects in one request.
+        Use _OBJECTS_=someObjectListGetter() to set the list of objects of which to call functions.
+        Defaults to getActivePlayerShips()
+
+        Syntax: /getmulti.lua?_OBJECTS_={getPlayerShip(1), getPlayerShip(2)}&dictionaryKey=functionName("arguments)
 
-        luaCode = "object = " + objectId + "\n" +
-                  "if object == nil then return {error = \"No valid object\"} end\n" +
-                  "return {";
+        Example: /getmulti.lua?_OBJECTS_={getPlayerShip(1), getPlayerShip(2)}&hull=getHull()&energy=getEnergy()
 
-        // Loop through URL parameters
+        Returns a list with a dictionary for each object: [{hull = 100, energy = 800}, {hull = 50, energy = 1000}]
+        */
+        if (!gameGlobalInfo)
+        {
+            return "{\"ERROR\": \"No game\"}";
+        }
+
+        std::unordered_map<string, string>::const_iterator i;
         for (i = request.query.begin(); i != request.query.end(); i++)
         {
-            if (i->first == sOBJECT)
+            if (i->first == sOBJECTS)
                 continue;
-            // Fail if trying to set stuff. We only do get.
             if (i->second.substr(0, 3) == "set")
             {
-                return "{\"ERROR\": \"Cannot set values through get.lua\", \"COMMAND\": \"" + i->second + "\"}";
+                return "{\"ERROR\": \"Cannot set values through getmulti.lua\", \"COMMAND\": \"" + i->second + "\"}";
             }
-            // Build LUA-code
-            luaCode += i->first + " = object:" + i->second + ", ";
-        }   luaCode += "}";
+        }
 
-        // Run script
-        script = new ScriptObject();
-        script->setMaxRunCycles(100000);
+        string output;
+        bool success = runQuery(normalizedQuery("getmulti", request.query), [&request]()
+        {
+            string objectsId = "getActivePlayerShips()";
+            auto i = request.query.find(sOBJECTS);
+            if (i != request.query.end())
+            {
+                objectsId = i->second;
+            }
 
-        // Return dictionary with error, else output
-        if (!script->runCode(luaCode, output))
+            string luaCode = "local objects = " + objectsId + "\n" +
+                             "if objects == nil then return {error = \"No valid objects\"} end\n" +
+                             "local result = {}\n" +
+                             "for index, object in ipairs(objects) do\n" +
+                             "    result[index] = {";
+            for (i = request.query.begin(); i != request.query.end(); i++)
+            {
+                if (i->first == sOBJECTS)
+                    continue;
+                luaCode += i->first + " = object:" + i->second + ", ";
+            }
+            luaCode += "}\nend\nreturn result";
+            return luaCode;
+        }, output);
+
+        if (!success)
         {
             output = "{\"ERROR\": \"Script error\"}";
         }
-        script->destroy();
         return output;
     });
-    server.addURLHandler("/set.lua", [](const sp::io::http::Server::Request& request) -> string
+    server.addURLHandler("/subscribe.lua", [this](const sp::io::http::Server::Request& request) -> string
+    {
+        /*
+        Subscribe to the results of LUA-exposed functions, instead of polling get.lua.
+        Uses the same syntax as get.lua, with _RATE_ setting how many times per second the functions are called (default 10).
+
+        Example: /subscribe.lua?_RATE_=20&hull=getHull()&nukes=getWeaponStorage("nuke")
+
+        Returns the subscription id: {"id": 1}
+        Poll /poll.lua?id=1 to get the values that changed since the previous poll. The first poll returns all values.
+        Subscriptions are removed when they are not polled for 10 seconds.
+        */
+        if (!gameGlobalInfo)
+        {
+            return "{\"ERROR\": \"No game\"}";
+        }
+        return subscribe(request);
+    });
+    server.addURLHandler("/poll.lua", [this](const sp::io::http::Server::Request& request) -> string
+    {
+        if (!gameGlobalInfo)
+        {
+            return "{\"ERROR\": \"No game\"}";
+        }
+        return poll(request);
+    });
+    server.addURLHandler("/set.lua", [this](const sp::io::http::Server::Request& request) -> string
     {
         /*
         Call LUA-exposed functions with arguments.
@@ -112,39 +223,189 @@ EEHttpServer::EEHttpServer(int port, string static_file_path)
             return "{\"ERROR\": \"No game\"}";
         }
 
-        string luaCode;
-        string objectId = "getPlayerShip(-1)";
-        std::unordered_map<string, string>::const_iterator i;
-        P<ScriptObject> script;
         string output;
-
-        i = request.query.find(sOBJECT);
-        if (i != request.query.end())
+        bool success = runQuery(normalizedQuery("set", request.query), [&request]()
         {
-            objectId = i->first;
-        }
+            string luaCode;
+            string objectId = "getPlayerShip(-1)";
 
-        luaCode = "object = " + objectId + "\n" +
-               "if object == nil then return {error = \"No valid object\"} end\n";
+            auto i = request.query.find(sOBJECT);
+            if (i != request.query.end())
+            {
+                objectId = i->second;
+            }
 
-        for (i = request.query.begin(); i != request.query.end(); i++)
-        {
-            if (i->first == sOBJECT)
-                continue;
-            if (i->second == "")
-                luaCode += "object:" + i->first + ";\n";
-            else
-                luaCode += i->first + ":" + i->second + ";\n";
-        }
+            luaCode = "local object = " + objectId + "\n" +
+                   "if object == nil then return {error = \"No valid object\"} end\n";
 
-        script = new ScriptObject();
-        script->setMaxRunCycles(100000);
+            for (i = request.query.begin(); i != request.query.end(); i++)
+            {
+                if (i->first == sOBJECT)
+                    continue;
+                if (i->second == "")
+                    luaCode += "object:" + i->first + ";\n";
+                else
+                    luaCode += i->first + ":" + i->second + ";\n";
+            }
+            return luaCode;
+        }, output);
 
-        if (!script->runCode(luaCode, output))
+        if (!success)
             output = "{\"ERROR\": \"Script error\"}";
         else
             output = "{}";
-        script->destroy();
         return output;
     });
 }
+
+bool EEHttpServer::runQuery(const string& key, const std::function<string()>& build_function_body, string& output)
+{
+    auto it = query_functions.find(key);
+    if (!query_script || (it == query_functions.end() && query_functions.size() >= max_query_functions))
+    {
+        // Start with a fresh script, so the functions of old queries are released.
+        if (query_script)
+            query_script->destroy();
+        query_script = new ScriptObject();
+        query_script->setMaxRunCycles(100000);
+        query_functions.clear();
+        it = query_functions.end();
+    }
+
+    if (it == query_functions.end())
+    {
+        string function_name = "__http_query_" + string(query_function_counter++);
+        string ignored;
+        if (!query_script->runCode("function " + function_name + "()\n" + build_function_body() + "\nend", ignored))
+            return false;
+        it = query_functions.emplace(key, function_name).first;
+    }
+    return query_script->runCode("return " + it->second + "()", output);
+}
+
+string EEHttpServer::subscribe(const sp::io::http::Server::Request& request)
+{
+    string objectId = "getPlayerShip(-1)";
+    float rate = 10.0f;
+    string getters;
+    for (auto i = request.query.begin(); i != request.query.end(); i++)
+    {
+        if (i->first == sOBJECT)
+        {
+            objectId = i->second;
+            continue;
+        }
+        if (i->first == sRATE)
+        {
+            rate = std::clamp(i->second.toFloat(), 0.1f, 60.0f);
+            continue;
+        }
+        if (i->second.substr(0, 3) == "set")
+        {
+            return "{\"ERROR\": \"Cannot set values through subscribe.lua\", \"COMMAND\": \"" + i->second + "\"}";
+        }
+        getters += i->first + " = object:" + i->second + ", ";
+    }
+    if (subscriptions.size() >= max_subscriptions)
+    {
+        return "{\"ERROR\": \"Too many subscriptions\"}";
+    }
+
+    if (!subscription_script)
+    {
+        subscription_script = new ScriptObject();
+        subscription_script->setMaxRunCycles(100000);
+    }
+
+    // The update function stores changed values in the pending table, the take function returns and clears it.
+    int id = ++subscription_counter;
+    string function_name = "__http_subscription_" + string(id);
+    string luaCode =
+        "local previous = {}\n"
+        "local pending = {}\n"
+        "function " + function_name + "_update()\n"
+        "    local object = " + objectId + "\n"
+        "    if object == nil then pending.error = \"No valid object\" return end\n"
+        "    for key, value in pairs({" + getters + "}) do\n"
+        "        if previous[key] ~= value then\n"
+        "            previous[key] = value\n"
+        "            pending[key] = value\n"
+        "        end\n"
+        "    end\n"
+        "end\n"
+        "function " + function_name + "_take()\n"
+        "    local result = pending\n"
+        "    pending = {}\n"
+        "    return result\n"
+        "end\n";
+    string ignored;
+    if (!subscription_script->runCode(luaCode, ignored) || !subscription_script->runCode(function_name + "_update()", ignored))
+    {
+        return "{\"ERROR\": \"Script error\"}";
+    }
+
+    Subscription& subscription = subscriptions[id];
+    subscription.function_name = function_name;
+    subscription.interval = 1.0f / rate;
+    subscription.delay = subscription.interval;
+    subscription.time_since_poll = 0.0f;
+    return "{\"id\": " + string(id) + "}";
+}
+
+string EEHttpServer::poll(const sp::io::http::Server::Request& request)
+{
+    auto i = request.query.find("id");
+    if (i == request.query.end())
+    {
+        return "{\"ERROR\": \"No subscription id\"}";
+    }
+    auto it = subscriptions.find(i->second.toInt());
+    if (it == subscriptions.end() || !subscription_script)
+    {
+        return "{\"ERROR\": \"Unknown subscription\"}";
+    }
+
+    it->second.time_since_poll = 0.0f;
+    string output;
+    if (!subscription_script->runCode("return " + it->second.function_name + "_take()", output))
+    {
+        output = "{\"ERROR\": \"Script error\"}";
+    }
+    return output;
+}
+
+void EEHttpServer::update(float delta)
+{
+    // Use real time, so subscriptions keep updating while the game is paused.
+    float real_delta = subscription_clock.restart();
+    if (subscriptions.empty())
+        return;
+    if (!gameGlobalInfo || !subscription_script)
+    {
+        subscriptions.clear();
+        return;
+    }
+
+    string ignored;
+    for(auto it = subscriptions.begin(); it != subscriptions.end(); )
+    {
+        Subscription& subscription = it->second;
+        subscription.time_since_poll += real_delta;
+        if (subscription.time_since_poll > subscription_timeout)
+        {
+            subscription_script->runCode(subscription.function_name + "_update = nil " + subscription.function_name + "_take = nil", ignored);
+            it = subscriptions.erase(it);
+            continue;
+        }
+
+        subscription.delay -= real_delta;
+        if (subscription.delay <= 0.0f)
+        {
+            subscription.delay += subscription.interval;
+            if (subscription.delay < 0.0f)
+                subscription.delay = subscription.interval;
+            subscription_script->runCode(subscription.function_name + "_update()", ignored);
+        }
+        ++it;
+    }
+}
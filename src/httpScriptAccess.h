@@ -2,14 +2,50 @@
 #define HTTP_SCRIPT_ACCESS_H
 
 #include "io/http/server.h"
+#include "scriptInterface.h"
+#include "Updatable.h"
+#include "timer.h"
+#include <functional>
+#include <unordered_map>
 
-class EEHttpServer
+class EEHttpServer : public Updatable
 {
 public:
     EEHttpServer(int port, string static_file_path);
 
+    virtual void update(float delta) override;
+
 private:
     sp::io::http::Server server;
+
+    // Persistent script used to run the get/set requests. Each distinct query is compiled once into a function inside
+    // this script, so repeated requests only need to call that function instead of building and compiling a new script.
+    P<ScriptObject> query_script;
+    std::unordered_map<string, string> query_functions;
+    int query_function_counter = 0;
+    static constexpr size_t max_query_functions = 256;
+
+    bool runQuery(const string& key, const std::function<string()>& build_function_body, string& output);
+
+    // Subscriptions evaluate their getters at a fixed rate, and collect the values that changed until the client polls them.
+    class Subscription
+    {
+    public:
+        string function_name;
+        float interval;
+        float delay;
+        float time_since_poll;
+    };
+    // Subscriptions that are not polled for this amount of seconds are removed.
+    static constexpr float subscription_timeout = 10.0f;
+    static constexpr size_t max_subscriptions = 64;
+    P<ScriptObject> subscription_script;
+    std::unordered_map<int, Subscription> subscriptions;
+    int subscription_counter = 0;
+    sp::SystemStopwatch subscription_clock;
+
+    string subscribe(const sp::io::http::Server::Request& request);
+    string poll(const sp::io::http::Server::Request& request);
 };
 
 #endif//HTTP_SCRIPT_ACCESS_H
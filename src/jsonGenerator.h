@@ -0,0 +1,129 @@
+#ifndef JSON_GENERATOR_H
+#define JSON_GENERATOR_H
+
+//We need a really fast float to string conversion. dtoa from milo does this very well.
+#include "dtoa/dtoa_milo.h"
+#include <string>
+#include <string.h>
+
+// Minimal JSON writer used by the GameStateLogger. Writes directly into a buffer that must be large enough.
+// The object is closed when the generator goes out of scope.
+class JSONGenerator
+{
+public:
+    JSONGenerator(char*& ptr)
+    : ptr(ptr), first(true)
+    {
+        *ptr++ = '{';
+    }
+
+    ~JSONGenerator()
+    {
+        *ptr++ = '}';
+    }
+
+    template<typename T> void write(const char* key, const T& value)
+    {
+        if (!first)
+            *ptr++ = ',';
+        *ptr++ = '"';
+        while(*key)
+            *ptr++ = *key++;
+        *ptr++ = '"';
+        *ptr++ = ':';
+        first = false;
+        writeValue(value);
+    }
+    JSONGenerator createDict(const char* key)
+    {
+        if (!first)
+            *ptr++ = ',';
+        *ptr++ = '"';
+        while(*key)
+            *ptr++ = *key++;
+        *ptr++ = '"';
+        *ptr++ = ':';
+        first = false;
+        return JSONGenerator(ptr);
+    }
+    void startArray(const char* key)
+    {
+        if (!first)
+            *ptr++ = ',';
+        *ptr++ = '"';
+        while(*key)
+            *ptr++ = *key++;
+        *ptr++ = '"';
+        *ptr++ = ':';
+        *ptr++ = '[';
+        first = false;
+        array_first = true;
+    }
+    JSONGenerator arrayCreateDict()
+    {
+        if (!array_first)
+            *ptr++ = ',';
+        array_first = false;
+        return JSONGenerator(ptr);
+    }
+    template<typename T> void arrayWrite(const T& value)
+    {
+        if (!array_first)
+            *ptr++ = ',';
+        array_first = false;
+        writeValue(value);
+    }
+    void endArray()
+    {
+        *ptr++ = ']';
+        first = false;
+        array_first = true;
+    }
+private:
+    void writeValue(bool b)
+    {
+        const char* c = "false";
+        if (b) c = "true";
+        while(*c)
+            *ptr++ = *c++;
+    }
+    void writeValue(int i)
+    {
+        unsigned int u = i;
+        if (i < 0)
+        {
+            *ptr++ = '-';
+            u = 0u - u;
+        }
+        char digits[10];
+        int count = 0;
+        do
+        {
+            digits[count++] = '0' + (u % 10);
+            u /= 10;
+        } while(u);
+        while(count)
+            *ptr++ = digits[--count];
+    }
+    void writeValue(float _f) { dtoa_milo(_f, ptr); ptr += strlen(ptr); }
+    void writeValue(const char* value)
+    { /*ptr += sprintf(ptr, "\"%s\"", value);*/
+        *ptr++ = '"';
+        while(*value)
+            *ptr++ = *value++;
+        *ptr++ = '"';
+    }
+    void writeValue(const std::string& value)
+    {
+        const char* str = value.c_str();
+        *ptr++ = '"';
+        while(*str)
+            *ptr++ = *str++;
+        *ptr++ = '"';
+    }
+
+    char*& ptr;
+    bool first, array_first;
+};
+
+#endif//JSON_GENERATOR_H
@@ -29,6 +29,7 @@
 #include "httpScriptAccess.h"
 #include "preferenceManager.h"
 #include "networkRecorder.h"
+#include "replicationProfiler.h"
 #include "tutorialGame.h"
 #include "windowManager.h"
 
@@ -128,6 +129,7 @@ int main(int argc, char** argv)
     }
 
     new Engine();
+    ReplicationProfiler::initialize();
 
     if (PreferencesManager::get("proxy") != "")
     {
@@ -338,6 +340,7 @@ int main(int argc, char** argv)
     }
 
     engine->runMainLoop();
+    ReplicationProfiler::writeReport();
 
     // Set FSAA and fullscreen defaults from windowManager.
     
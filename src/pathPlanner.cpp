@@ -1,95 +1,101 @@
 #include "pathPlanner.h"
 #include "spaceObjects/spaceObject.h"
+#include <algorithm>
 
 
-const float small_object_grid_size = 5000.0f;
-const float small_object_max_size = 1000.0f;
-
-static uint32_t hashSector(uint32_t x, uint32_t y)
-{
-    return (x) ^ (y << 16);
-}
-
-static uint32_t positionToSector(float f)
-{
-    return std::lrint(f / small_object_grid_size);
-}
-
-static uint32_t hashPosition(glm::vec2 position)
-{
-    return hashSector(positionToSector(position.x), positionToSector(position.y));
-}
+// Maximum time in seconds spend on solving queued route plans per update. At least one plan is solved every update.
+const float plan_time_budget = 0.002f;
 
 P<PathPlannerManager> PathPlannerManager::instance;
 
 void PathPlannerManager::addAvoidObject(P<SpaceObject> source, float size)
 {
-    // Make a classification for small objects which fit in a grid, so the checkToAvoid function does not has to iterate on all objects.
-    // Until then, astroids and mines should not generate avoidAreas to prevent performance issues.
-    if (size < small_object_max_size)
-    {
-        uint32_t hash = hashPosition(source->getPosition());
-        small_objects[hash].push_back(PathPlannerAvoidObject(source, size));
-    }else{
-        big_objects.push_back(PathPlannerAvoidObject(source, size));
-    }
+    if (!source)
+        return;
+    sources.push_back(source);
+    // Small objects fit in a grid, so the checkToAvoid function does not has to iterate on all objects.
+    grid.add(source->getPosition(), size);
 }
 
 void PathPlannerManager::update(float delta)
 {
-    for(std::list<PathPlannerManager::PathPlannerAvoidObject>::iterator i = big_objects.begin(); i != big_objects.end(); )
+    // Iterate backwards, so objects swapped into a removed slot are already updated.
+    for(uint32_t index = sources.size(); index > 0; index--)
     {
-        if (i->source)
+        uint32_t n = index - 1;
+        if (!sources[n])
         {
-            i++;
-        }else{
-            i = big_objects.erase(i);
+            grid.remove(n);
+            sources[n] = sources.back();
+            sources.pop_back();
+            continue;
         }
+        grid.setPosition(n, sources[n]->getPosition());
     }
 
-    std::vector<PathPlannerAvoidObject> add_list;
-    for(auto h_it = small_objects.begin(); h_it != small_objects.end(); h_it++)
+    sp::SystemStopwatch budget_timer;
+    float elapsed = 0.0f;
+    while(!plan_queue.empty())
     {
-        for(auto it = h_it->second.begin(); it != h_it->second.end();)
-        {
-            if (it->source && hashPosition(it->source->getPosition()) == h_it->first)
-            {
-                it++;
-            }else{
-                if (it->source)
-                {
-                    add_list.emplace_back(it->source, it->size);
-                }
+        PathPlanner* planner = plan_queue.front();
+        plan_queue.pop_front();
+        planner->solvePlan();
 
-                it = h_it->second.erase(it);
-            }
-        }
-    }
-    for(PathPlannerAvoidObject& obj : add_list)
-    {
-        if (obj.source)
-            small_objects[hashPosition(obj.source->getPosition())].emplace_back(obj.source, obj.size);
+        elapsed += budget_timer.restart();
+        if (elapsed > plan_time_budget)
+            break;
     }
 }
 
+void PathPlannerManager::queuePlan(PathPlanner* planner)
+{
+    plan_queue.push_back(planner);
+}
+
+void PathPlannerManager::cancelPlan(PathPlanner* planner)
+{
+    auto it = std::find(plan_queue.begin(), plan_queue.end(), planner);
+    if (it != plan_queue.end())
+        plan_queue.erase(it);
+}
+
+bool PathPlannerManager::querySegment(glm::vec2 start, glm::vec2 end, float margin, AvoidResult& result)
+{
+    return grid.querySegment(start, end, margin, result, [this](uint32_t index) { return !sources[index]; });
+}
+
 PathPlanner::PathPlanner(float my_size)
 : my_size(my_size)
 {
     manager = PathPlannerManager::getInstance();
 }
 
+PathPlanner::~PathPlanner()
+{
+    if (plan_pending && manager)
+        manager->cancelPlan(this);
+}
+
 void PathPlanner::plan(glm::vec2 start, glm::vec2 end)
 {
     if (route.size() == 0 || glm::length(route.back() - end) > 2000)
     {
+        // Planning a fresh route is costly, so it is queued at the manager, which solves it within its per-frame budget.
+        // Until the route is ready, head straight for the target.
         route.clear();
-        int recursion_counter = 0;
-        recursivePlan(start, end, recursion_counter);
         route.push_back(end);
-
-        insert_idx = 0;
-        remove_idx = 1;
-        remove_idx2 = 1;
+        plan_start = start;
+        plan_end = end;
+        if (!plan_pending)
+        {
+            plan_pending = true;
+            manager->queuePlan(this);
+        }
+    }else if (plan_pending)
+    {
+        route.back() = end;
+        plan_start = start;
+        plan_end = end;
     }else{
         route.back() = end;
 
@@ -142,6 +148,25 @@ void PathPlanner::plan(glm::vec2 start, glm::vec2 end)
 void PathPlanner::clear()
 {
     route.clear();
+    if (plan_pending)
+    {
+        plan_pending = false;
+        manager->cancelPlan(this);
+    }
+}
+
+void PathPlanner::solvePlan()
+{
+    plan_pending = false;
+
+    route.clear();
+    int recursion_counter = 0;
+    recursivePlan(plan_start, plan_end, recursion_counter);
+    route.push_back(plan_end);
+
+    insert_idx = 0;
+    remove_idx = 1;
+    remove_idx2 = 1;
 }
 
 void PathPlanner::recursivePlan(glm::vec2 start, glm::vec2 end, int& recursion_counter)
@@ -159,121 +184,18 @@ void PathPlanner::recursivePlan(glm::vec2 start, glm::vec2 end, int& recursion_c
 
 bool PathPlanner::checkToAvoid(glm::vec2 start, glm::vec2 end, glm::vec2& new_point, glm::vec2* alt_point)
 {
-    glm::vec2 startEndDiff = end - start;
-    float startEndLength = glm::length(startEndDiff);
-    if (startEndLength < 100.0f)
+    if (glm::length2(end - start) < 100.0f * 100.0f)
         return false;
-    float firstAvoidF = startEndLength;
-    PathPlannerManager::PathPlannerAvoidObject avoidObject(NULL, 0);
-    glm::vec2 firstAvoidQ{};
-
-    for(std::list<PathPlannerManager::PathPlannerAvoidObject>::iterator i = manager->big_objects.begin(); i != manager->big_objects.end(); )
-    {
-        if (i->source)
-        {
-            auto position = i->source->getPosition();
-            float f = glm::dot(startEndDiff, position - start) / startEndLength;
-            if (f > 0 && f < startEndLength - i->size)
-            {
-                glm::vec2 q = start + startEndDiff / startEndLength * f;
-                if (glm::length2(q - position) < (i->size + my_size) * (i->size + my_size))
-                {
-                    if (f < firstAvoidF)
-                    {
-                        avoidObject = *i;
-                        firstAvoidF = f;
-                        firstAvoidQ = q;
-                    }
-                }
-            }
-            i++;
-        }else{
-            i = manager->big_objects.erase(i);
-        }
-    }
-
-    {
-        // Bresenham's line algorithm to
-        int x1 = positionToSector(start.x);
-        int y1 = positionToSector(start.y);
-        int x2 = positionToSector(end.x);
-        int y2 = positionToSector(end.y);
 
-        const bool steep = abs(y2 - y1) > abs(x2 - x1);
-        if(steep)
-        {
-            std::swap(x1, y1);
-            std::swap(x2, y2);
-        }
-
-        if(x1 > x2)
-        {
-            std::swap(x1, x2);
-            std::swap(y1, y2);
-        }
-
-        const int dx = x2 - x1;
-        const int dy = abs(y2 - y1);
-
-        int error = dx / 2;
-        const int ystep = (y1 < y2) ? 1 : -1;
-        int y = y1;
-
-        for(int x=x1; x<=x2; x++)
-        {
-            uint32_t hash;
-            if(steep)
-            {
-                hash = hashSector(y, x);
-            }
-            else
-            {
-                hash = hashSector(x, y);
-            }
-
-            for(std::list<PathPlannerManager::PathPlannerAvoidObject>::iterator i = manager->small_objects[hash].begin(); i != manager->small_objects[hash].end(); )
-            {
-                if (i->source)
-                {
-                    glm::vec2 position = i->source->getPosition();
-                    float f = glm::dot(startEndDiff, position - start) / startEndLength;
-                    if (f > 0 && f < startEndLength - i->size)
-                    {
-                        glm::vec2 q = start + startEndDiff / startEndLength * f;
-                        if (glm::length2(q - position) < (i->size + my_size) * (i->size + my_size))
-                        {
-                            if (f < firstAvoidF)
-                            {
-                                avoidObject = *i;
-                                firstAvoidF = f;
-                                firstAvoidQ = q;
-                            }
-                        }
-                    }
-                    i++;
-                }else{
-                    i = manager->small_objects[hash].erase(i);
-                }
-            }
-
-            error -= dy;
-            if(error < 0)
-            {
-                y += ystep;
-                error += dx;
-            }
-        }
-    }
+    PathPlannerManager::AvoidResult avoid;
+    if (!manager->querySegment(start, end, my_size, avoid))
+        return false;
 
-    if (firstAvoidF < startEndLength)
-    {
-        glm::vec2 position = avoidObject.source->getPosition();
-        if (firstAvoidQ.x == position.x && firstAvoidQ.y == position.y)
-            firstAvoidQ.x += 0.1f;
-        new_point = position + glm::normalize(firstAvoidQ - position) * (avoidObject.size * 1.1f + my_size);
-        if (alt_point)
-            *alt_point = position - glm::normalize(firstAvoidQ - position) * (avoidObject.size * 1.1f + my_size);
-        return true;
-    }
-    return false;
+    glm::vec2 firstAvoidQ = avoid.closest;
+    if (firstAvoidQ.x == avoid.position.x && firstAvoidQ.y == avoid.position.y)
+        firstAvoidQ.x += 0.1f;
+    new_point = avoid.position + glm::normalize(firstAvoidQ - avoid.position) * (avoid.size * 1.1f + my_size);
+    if (alt_point)
+        *alt_point = avoid.position - glm::normalize(firstAvoidQ - avoid.position) * (avoid.size * 1.1f + my_size);
+    return true;
 }
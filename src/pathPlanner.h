@@ -2,31 +2,37 @@
 #define PATH_PLANNER_H
 
 #include "spaceObjects/spaceObject.h"
-#include <list>
+#include "avoidObjectGrid.h"
+#include "timer.h"
+#include <vector>
+#include <deque>
+
+class PathPlanner;
 
 class PathPlannerManager : public Updatable
 {
     static P<PathPlannerManager> instance;
 
-    class PathPlannerAvoidObject
-    {
-    public:
-        P<SpaceObject> source;
-        float size;
-
-        PathPlannerAvoidObject(P<SpaceObject> source, float size) : source(source), size(size) {}
-    };
-    std::list<PathPlannerAvoidObject> big_objects;
-    std::unordered_map<uint32_t, std::list<PathPlannerAvoidObject> > small_objects;
+    // The source of each avoid object, indexed by the same slot as the grid.
+    std::vector<P<SpaceObject>> sources;
+    AvoidObjectGrid grid;
 
+    // Planners waiting for a full route plan. These are solved in update() within the per-frame planning budget.
+    std::deque<PathPlanner*> plan_queue;
 public:
+    typedef AvoidObjectGrid::Result AvoidResult;
+
     virtual void update(float delta) override;
 
     void addAvoidObject(P<SpaceObject> source, float size);
 
-    static P<PathPlannerManager> getInstance() { if (!instance) instance = new PathPlannerManager(); return *instance; }
+    // Find the first avoid object along the segment from start to end that is closer then (object size + margin) to the segment.
+    bool querySegment(glm::vec2 start, glm::vec2 end, float margin, AvoidResult& result);
 
-    friend class PathPlanner;
+    void queuePlan(PathPlanner* planner);
+    void cancelPlan(PathPlanner* planner);
+
+    static P<PathPlannerManager> getInstance() { if (!instance) instance = new PathPlannerManager(); return *instance; }
 };
 
 //The path planner is used to plan a route trough the world map without hitting any objects.
@@ -36,16 +42,23 @@ private:
     unsigned int insert_idx, remove_idx, remove_idx2;
     float my_size = 0.0f;
     P<PathPlannerManager> manager;
+    bool plan_pending = false;
+    glm::vec2 plan_start{};
+    glm::vec2 plan_end{};
 public:
     PathPlanner(float my_size);
+    ~PathPlanner();
 
     std::vector<glm::vec2> route;
 
     void plan(glm::vec2 start, glm::vec2 end);
     void clear();
 private:
+    void solvePlan();
     void recursivePlan(glm::vec2 start, glm::vec2 end, int& recursion_counter);
     bool checkToAvoid(glm::vec2 start, glm::vec2 end, glm::vec2& new_point, glm::vec2* alt_point=NULL);
+
+    friend class PathPlannerManager;
 };
 
 #endif//PATH_PLANNER_H
@@ -0,0 +1,44 @@
+#include "quantizedReplication.h"
+#include "multiplayer_server.h"
+
+#include <algorithm>
+#include <cmath>
+
+//An even step count puts the center of the range on an exact step, so for a [-1, 1] range -1, 0 and 1 all survive the round trip.
+static constexpr float quantize_steps = 65534.0f;
+
+void QuantizedReplication::update()
+{
+    if (game_server)
+    {
+        for(auto& entry : entries)
+            entry.encoded = entry.angle ? encodeAngle(*entry.value) : encode(*entry.value, entry.min, entry.range);
+    }
+    else
+    {
+        for(auto& entry : entries)
+        {
+            if (entry.encoded == entry.decoded)
+                continue;
+            entry.decoded = entry.encoded;
+            if (entry.angle)
+                *entry.value = entry.encoded * (360.0f / 65536.0f);
+            else
+                *entry.value = entry.min + entry.range * (entry.encoded / quantize_steps);
+        }
+    }
+}
+
+uint16_t QuantizedReplication::encode(float value, float min, float range)
+{
+    float f = std::clamp((value - min) / range, 0.0f, 1.0f);
+    return uint16_t(std::lround(f * quantize_steps));
+}
+
+uint16_t QuantizedReplication::encodeAngle(float angle)
+{
+    float f = std::fmod(angle, 360.0f);
+    if (f < 0.0f)
+        f += 360.0f;
+    return uint16_t(std::lround(f * (65536.0f / 360.0f)) & 0xFFFF);
+}
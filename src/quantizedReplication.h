@@ -0,0 +1,52 @@
+#ifndef QUANTIZED_REPLICATION_H
+#define QUANTIZED_REPLICATION_H
+
+#include <list>
+#include <stdint.h>
+
+/*
+ * Replicates float members with a known range as 16 bit fixed point values instead of full floats.
+ * The server encodes the floats every update, and only the encoded value is registered for replication.
+ * Clients decode received values back into the original floats, which the rest of the code keeps using.
+ * This halves the payload of these members, and members that only drift by tiny amounts are no longer resent.
+ */
+class QuantizedReplication
+{
+public:
+    // Replicate a float in the [min, max] range, values outside the range are clamped on the wire.
+    template<class T> void add(T* owner, float* value, float min, float max, float update_delay = 0.0f)
+    {
+        entries.push_back({value, min, max - min, false, encode(*value, min, max - min), 0});
+        entries.back().decoded = entries.back().encoded;
+        owner->registerMemberReplication(&entries.back().encoded, update_delay);
+    }
+    // Replicate an angle in degrees, at 360/65536 degree resolution.
+    template<class T> void addAngle(T* owner, float* value, float update_delay = 0.0f)
+    {
+        entries.push_back({value, 0.0f, 360.0f, true, encodeAngle(*value), 0});
+        entries.back().decoded = entries.back().encoded;
+        owner->registerMemberReplication(&entries.back().encoded, update_delay);
+    }
+
+    // Encode the values on the server, decode the received values on clients. Call once per update.
+    void update();
+private:
+    class Entry
+    {
+    public:
+        float* value;
+        float min;
+        float range;
+        bool angle;
+        uint16_t encoded;
+        // Last value written to the float on clients, so local changes in between received updates are kept.
+        uint16_t decoded;
+    };
+    // A list, as the replication keeps pointers to the encoded values.
+    std::list<Entry> entries;
+
+    static uint16_t encode(float value, float min, float range);
+    static uint16_t encodeAngle(float angle);
+};
+
+#endif//QUANTIZED_REPLICATION_H
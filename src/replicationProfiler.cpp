@@ -0,0 +1,235 @@
+#include "replicationProfiler.h"
+#include "multiplayer_server.h"
+#include "preferenceManager.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+ReplicationProfiler* ReplicationProfiler::instance = nullptr;
+
+ReplicationProfiler::ReplicationProfiler()
+{
+    instance = this;
+    elapsed_time = 0.0f;
+    window_time = 0.0f;
+    server_update_time = 0.0f;
+    server_update_samples = 0;
+    report_file = PreferencesManager::get("replication_report");
+    report_interval = std::max(1.0f, PreferencesManager::get("replication_report_interval", "60").toFloat());
+    report_delay = report_interval;
+}
+
+ReplicationProfiler::~ReplicationProfiler()
+{
+    writeReport();
+    if (instance == this)
+        instance = nullptr;
+}
+
+void ReplicationProfiler::initialize()
+{
+    if (instance)
+        return;
+    if (PreferencesManager::get("replication_profiler") != "1" && PreferencesManager::get("replication_report") == "")
+        return;
+    LOG(INFO) << "Replication profiler enabled";
+    new ReplicationProfiler();
+}
+
+void ReplicationProfiler::registerObject(MultiplayerObject* object, const string& class_name)
+{
+    //Only the server sends replication data, objects created on clients are not of interest.
+    if (!instance || !game_server)
+        return;
+    auto it = instance->class_lookup.find(class_name);
+    int index;
+    if (it == instance->class_lookup.end())
+    {
+        index = int(instance->classes.size());
+        instance->class_lookup[class_name] = index;
+        instance->classes.push_back({class_name, 0, 0, 0, 0, 0, 0.0f, {}});
+    }
+    else
+    {
+        index = it->second;
+    }
+    auto& stats = instance->classes[index];
+    stats.object_count++;
+    stats.peak_object_count = std::max(stats.peak_object_count, stats.object_count);
+    auto& tracked = instance->objects[object];
+    tracked.class_index = index;
+    tracked.members.clear();
+}
+
+void ReplicationProfiler::unregisterObject(MultiplayerObject* object)
+{
+    if (!instance)
+        return;
+    auto it = instance->objects.find(object);
+    if (it == instance->objects.end())
+        return;
+    instance->classes[it->second.class_index].object_count--;
+    instance->objects.erase(it);
+}
+
+void ReplicationProfiler::addMember(MultiplayerObject* object, const char* name, const char* type_name, float update_delay, std::unique_ptr<TrackedMember> member)
+{
+    auto it = objects.find(object);
+    if (it == objects.end())
+        return;
+    auto& tracked = it->second;
+    auto& stats = classes[tracked.class_index];
+    //Objects of the same class register their members in the same order, so the registration index identifies the member.
+    if (stats.members.size() <= tracked.members.size())
+        stats.members.push_back({name, type_name, update_delay, 0, 0});
+    member->update_delay = update_delay;
+    member->next_sample = elapsed_time;
+    tracked.members.push_back(std::move(member));
+}
+
+void ReplicationProfiler::update(float delta)
+{
+    if (!game_server)
+        return;
+    elapsed_time += delta;
+    window_time += delta;
+    server_update_time += engine->getEngineTiming().server_update;
+    server_update_samples++;
+
+    for(auto& it : objects)
+    {
+        auto& tracked = it.second;
+        auto& stats = classes[tracked.class_index];
+        for(unsigned int n=0; n<tracked.members.size(); n++)
+        {
+            auto& member = tracked.members[n];
+            if (member->next_sample > elapsed_time)
+                continue;
+            size_t bytes = member->sample();
+            if (bytes == 0)
+                continue;
+            member->next_sample = elapsed_time + member->update_delay;
+            if (n < stats.members.size())
+            {
+                stats.members[n].changes++;
+                stats.members[n].bytes += bytes;
+            }
+            stats.changes++;
+            stats.bytes += bytes;
+            stats.window_bytes += bytes;
+        }
+    }
+
+    if (window_time >= rate_window)
+    {
+        for(auto& stats : classes)
+        {
+            stats.recent_rate = stats.window_bytes / window_time;
+            stats.window_bytes = 0;
+        }
+        window_time = 0.0f;
+    }
+
+    if (report_file != "")
+    {
+        report_delay -= delta;
+        if (report_delay <= 0.0f)
+        {
+            report_delay = report_interval;
+            writeReport();
+        }
+    }
+}
+
+string ReplicationProfiler::getReportJSON()
+{
+    if (!instance)
+        return "{\"ERROR\": \"Replication profiler not enabled, start with replication_profiler=1\"}";
+    float seconds = std::max(instance->elapsed_time, 0.001f);
+
+    std::vector<const ClassStats*> sorted;
+    for(auto& stats : instance->classes)
+        sorted.push_back(&stats);
+    std::sort(sorted.begin(), sorted.end(), [](const ClassStats* a, const ClassStats* b) { return a->bytes > b->bytes; });
+
+    string output = "{\"seconds\": " + string(seconds, 1);
+    if (instance->server_update_samples > 0)
+        output += ", \"server_update_ms\": " + string(instance->server_update_time / instance->server_update_samples * 1000.0f, 3);
+    if (game_server)
+        output += ", \"send_bytes_per_second\": " + string(game_server->getSendDataRate(), 0);
+    output += ", \"classes\": [";
+    bool first_class = true;
+    for(auto stats : sorted)
+    {
+        if (!first_class)
+            output += ", ";
+        first_class = false;
+        output += "{\"name\": \"" + stats->name + "\"";
+        output += ", \"objects\": " + string(stats->object_count);
+        output += ", \"peak_objects\": " + string(stats->peak_object_count);
+        output += ", \"changes\": " + string(std::to_string(stats->changes));
+        output += ", \"bytes\": " + string(std::to_string(stats->bytes));
+        output += ", \"bytes_per_second\": " + string(stats->bytes / seconds, 1);
+        output += ", \"members\": [";
+        for(unsigned int n=0; n<stats->members.size(); n++)
+        {
+            auto& member = stats->members[n];
+            if (n > 0)
+                output += ", ";
+            output += "{\"index\": " + string(int(n));
+            if (member.name)
+                output += ", \"name\": \"" + string(member.name) + "\"";
+            output += ", \"type\": \"" + string(member.type_name) + "\"";
+            output += ", \"update_delay\": " + string(member.update_delay, 2);
+            output += ", \"changes\": " + string(std::to_string(member.changes));
+            output += ", \"bytes\": " + string(std::to_string(member.bytes));
+            output += ", \"bytes_per_second\": " + string(member.bytes / seconds, 1) + "}";
+        }
+        output += "]}";
+    }
+    output += "]}";
+    return output;
+}
+
+string ReplicationProfiler::getOverlayText(unsigned int class_count)
+{
+    if (!instance)
+        return "";
+    std::vector<const ClassStats*> sorted;
+    for(auto& stats : instance->classes)
+        sorted.push_back(&stats);
+    std::sort(sorted.begin(), sorted.end(), [](const ClassStats* a, const ClassStats* b) { return a->recent_rate > b->recent_rate; });
+
+    string text = "Replication (estimated):\n";
+    for(unsigned int n=0; n<sorted.size() && n<class_count; n++)
+    {
+        auto stats = sorted[n];
+        if (stats->recent_rate <= 0.0f)
+            break;
+        int top_member = -1;
+        for(unsigned int m=0; m<stats->members.size(); m++)
+            if (top_member < 0 || stats->members[m].bytes > stats->members[top_member].bytes)
+                top_member = m;
+        text += "  " + stats->name + " x" + string(stats->object_count) + ": " + string(stats->recent_rate / 1000, 1) + " kb per second";
+        if (top_member >= 0)
+            text += " (top member #" + string(top_member) + " " + (stats->members[top_member].name ? stats->members[top_member].name : stats->members[top_member].type_name) + ")";
+        text += "\n";
+    }
+    return text;
+}
+
+void ReplicationProfiler::writeReport()
+{
+    if (!instance || instance->report_file == "")
+        return;
+    FILE* f = fopen(instance->report_file.c_str(), "wt");
+    if (!f)
+    {
+        LOG(WARNING) << "Failed to write replication report to: " << instance->report_file;
+        return;
+    }
+    string json = getReportJSON();
+    fwrite(json.c_str(), json.length(), 1, f);
+    fwrite("\n", 1, 1, f);
+    fclose(f);
+}
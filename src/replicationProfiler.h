@@ -0,0 +1,184 @@
+#ifndef REPLICATION_PROFILER_H
+#define REPLICATION_PROFILER_H
+
+#include "engine.h"
+#include "multiplayer.h"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * The ReplicationProfiler estimates how much replication traffic each object type and each replicated member causes.
+ * It is enabled with the "replication_profiler=1" preference, or with "replication_report=<file>", which also writes
+ * a JSON report to that file every "replication_report_interval" seconds (default 60) and when the game exits.
+ *
+ * The engine does not expose per member statistics, so the profiler mirrors what the server does: it samples every
+ * tracked member with the same update delay as the replication and counts the changes it sees.
+ * The byte counts are estimates of the payload (member value plus member index), not exact packet sizes.
+ *
+ * SpaceObjects register themselves and their members automatically, see SpaceObject::registerMemberReplication.
+ * Results are shown in the debug overlay, served as /replication.json by the http server and written to the report file.
+ */
+class ReplicationProfiler : public Updatable
+{
+public:
+    ReplicationProfiler();
+    virtual ~ReplicationProfiler();
+
+    virtual void update(float delta) override;
+
+    // Create the profiler when it is enabled in the preferences.
+    static void initialize();
+    static bool isEnabled() { return instance != nullptr; }
+
+    static void registerObject(MultiplayerObject* object, const string& class_name);
+    static void unregisterObject(MultiplayerObject* object);
+    template<typename T> static void trackMember(MultiplayerObject* object, T* member, float update_delay)
+    {
+        trackValue<T>(object, [member]() { return *member; }, update_delay);
+    }
+    // Track a value that is not a plain member, like the replicated collisionable state. The name must be a string literal.
+    template<typename T> static void trackValue(MultiplayerObject* object, std::function<T()> getter, float update_delay, const char* name = nullptr)
+    {
+        if (!instance)
+            return;
+        instance->addMember(object, name, memberTypeName<T>(), update_delay, std::make_unique<TrackedValue<T>>(getter));
+    }
+
+    static string getReportJSON();
+    // Short summary of the most expensive object types, for the debug overlay.
+    static string getOverlayText(unsigned int class_count);
+    static void writeReport();
+private:
+    class TrackedMember
+    {
+    public:
+        float update_delay;
+        float next_sample;
+
+        virtual ~TrackedMember() {}
+        // Returns the estimated amount of bytes sent for this member, or 0 when it did not change.
+        virtual size_t sample() = 0;
+    };
+
+    template<typename T, typename = void> struct isComparable : std::false_type {};
+    template<typename T> struct isComparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>> : std::true_type {};
+    template<typename T> struct isVector : std::false_type {};
+    template<typename T> struct isVector<std::vector<T>> : std::true_type {};
+
+    template<typename T> class TrackedValue : public TrackedMember
+    {
+    public:
+        std::function<T()> getter;
+        T previous;
+        bool first = true;
+
+        TrackedValue(std::function<T()> getter) : getter(getter) {}
+
+        virtual size_t sample() override
+        {
+            if constexpr (isComparable<T>::value)
+            {
+                T value = getter();
+                if (!first && value == previous)
+                    return 0;
+                first = false;
+                previous = value;
+                return member_index_size + valueSize(value);
+            }
+            return 0;
+        }
+    };
+
+    template<typename T> static size_t valueSize(const T& value)
+    {
+        if constexpr (std::is_same_v<T, string>)
+            return sizeof(uint32_t) + value.length();
+        else if constexpr (isVector<T>::value)
+            return sizeof(uint32_t) + value.size() * sizeof(typename T::value_type);
+        else
+            return sizeof(T);
+    }
+
+    template<typename T> static const char* memberTypeName()
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return "bool";
+        else if constexpr (std::is_same_v<T, float>)
+            return "float";
+        else if constexpr (std::is_enum_v<T>)
+            return "enum";
+        else if constexpr (std::is_integral_v<T>)
+            return "int";
+        else if constexpr (std::is_same_v<T, string>)
+            return "string";
+        else if constexpr (std::is_same_v<T, glm::vec2>)
+            return "vec2";
+        else if constexpr (std::is_same_v<T, glm::vec3>)
+            return "vec3";
+        else if constexpr (std::is_same_v<T, glm::u8vec4>)
+            return "color";
+        else if constexpr (isVector<T>::value)
+            return "vector";
+        else if constexpr (!isComparable<T>::value)
+            return "untracked";
+        else
+            return "other";
+    }
+
+    class MemberStats
+    {
+    public:
+        // Only set for tracked values, members are identified by their registration index and type.
+        const char* name;
+        const char* type_name;
+        float update_delay;
+        uint64_t changes;
+        uint64_t bytes;
+    };
+    class ClassStats
+    {
+    public:
+        string name;
+        int object_count;
+        int peak_object_count;
+        uint64_t changes;
+        uint64_t bytes;
+        uint64_t window_bytes;
+        float recent_rate;
+        std::vector<MemberStats> members;
+    };
+    class TrackedObject
+    {
+    public:
+        int class_index;
+        std::vector<std::unique_ptr<TrackedMember>> members;
+    };
+
+    // Estimated overhead per changed member, the engine sends the index of the member in front of the value.
+    static constexpr size_t member_index_size = sizeof(uint16_t);
+    static constexpr float rate_window = 1.0f;
+    static ReplicationProfiler* instance;
+
+    std::vector<ClassStats> classes;
+    std::map<string, int> class_lookup;
+    std::unordered_map<MultiplayerObject*, TrackedObject> objects;
+    float elapsed_time;
+    float window_time;
+    float server_update_time;
+    uint64_t server_update_samples;
+    string report_file;
+    float report_interval;
+    float report_delay;
+
+    void addMember(MultiplayerObject* object, const char* name, const char* type_name, float update_delay, std::unique_ptr<TrackedMember> member);
+};
+
+#endif//REPLICATION_PROFILER_H
@@ -0,0 +1,136 @@
+#include "radarContacts.h"
+#include "main.h"
+#include "playerInfo.h"
+#include "spaceObjects/nebula.h"
+#include "spaceObjects/scanProbe.h"
+#include "spaceObjects/shipTemplateBasedObject.h"
+
+#include <algorithm>
+
+P<RadarContacts> RadarContacts::instance;
+uint64_t RadarContacts::frame;
+RadarContacts::Snapshot RadarContacts::snapshots[RadarContacts::fog_style_count];
+
+void RadarContacts::update(float delta)
+{
+    frame++;
+}
+
+const std::vector<RadarContacts::Contact>& RadarContacts::get(GuiRadarView::EFogOfWarStyle fog_style)
+{
+    //The frame counter is advanced by the update of this object, created the first time a radar needs contacts.
+    if (!instance)
+        instance = new RadarContacts();
+
+    Snapshot& snapshot = snapshots[fog_style];
+    int32_t ship_id = my_spaceship ? my_spaceship->getMultiplayerId() : -1;
+    if (!snapshot.valid || snapshot.frame != frame || snapshot.ship_id != ship_id)
+    {
+        if (snapshot.ship_id != ship_id)
+            snapshot.coverage.clear();
+        build(snapshot, fog_style);
+        snapshot.frame = frame;
+        snapshot.ship_id = ship_id;
+        snapshot.valid = true;
+    }
+    return snapshot.contacts;
+}
+
+bool RadarContacts::isVisible(glm::vec2 position, float radius, GuiRadarView::EFogOfWarStyle fog_style)
+{
+    switch(fog_style)
+    {
+    case GuiRadarView::NoFogOfWar:
+        return true;
+    case GuiRadarView::FriendlysShortRangeFogOfWar:
+        return my_spaceship && snapshots[fog_style].coverage.isRevealed(position, radius);
+    case GuiRadarView::NebulaFogOfWar:
+        return !my_spaceship || !Nebula::blockedByNebula(my_spaceship->getPosition(), position, my_spaceship->getShortRangeRadarRange());
+    }
+    return true;
+}
+
+void RadarContacts::build(Snapshot& snapshot, GuiRadarView::EFogOfWarStyle fog_style)
+{
+    snapshot.contacts.clear();
+    snapshot.visible.clear();
+    auto add = [&snapshot](SpaceObject* obj)
+    {
+        if (snapshot.visible.insert(obj).second)
+            snapshot.contacts.push_back({obj, obj->getPosition(), obj->getRadius(), obj->getRadarLayer(), obj->canHideInNebula()});
+    };
+
+    switch(fog_style)
+    {
+    case GuiRadarView::NoFogOfWar:
+        foreach(SpaceObject, obj, space_object_list)
+        {
+            add(*obj);
+        }
+        break;
+    case GuiRadarView::FriendlysShortRangeFogOfWar:
+        // Reveal objects if they are within short-range radar range (or 5U) of
+        // a friendly ship, station, or scan probe.
+
+        // Continue only if the player's ship exists.
+        if (!my_spaceship)
+            break;
+
+        // Collect the revealers, and reveal all objects that cannot hide in a nebula.
+        snapshot.coverage.begin();
+        foreach(SpaceObject, obj, space_object_list)
+        {
+            // If the object can't hide in a nebula, it's considered visible.
+            if (!obj->canHideInNebula())
+            {
+                add(*obj);
+            }
+
+            // Consider the object only if it is:
+            // - Any ShipTemplateBasedObject (ship or station)
+            // - A SpaceObject belonging to a friendly faction
+            // - The player's ship
+            // - A scan probe owned by the player's ship
+            // This check is duplicated in RelayScreen::onDraw.
+            P<ShipTemplateBasedObject> stb_obj = obj;
+
+            if (!stb_obj
+                || (!obj->isFriendly(my_spaceship) && obj != my_spaceship))
+            {
+                P<ScanProbe> sp = obj;
+
+                if (!sp || sp->owner_id != my_spaceship->getMultiplayerId())
+                {
+                    continue;
+                }
+            }
+
+            // Set the radius to reveal as getShortRangeRadarRange() if the
+            // object's a ShipTemplateBasedObject. Otherwise, default to 5U.
+            float r = stb_obj ? stb_obj->getShortRangeRadarRange() : 5000.0f;
+            snapshot.coverage.setRevealer(obj->getMultiplayerId(), obj->getPosition(), r);
+        }
+        snapshot.coverage.end();
+
+        // Reveal the objects that are at least partially inside the range of a revealer.
+        foreach(SpaceObject, obj, space_object_list)
+        {
+            if (obj->canHideInNebula() && snapshot.coverage.isRevealed(obj->getPosition(), obj->getRadius()))
+                add(*obj);
+        }
+        break;
+    case GuiRadarView::NebulaFogOfWar:
+        foreach(SpaceObject, obj, space_object_list)
+        {
+            if (obj->canHideInNebula() && my_spaceship && Nebula::blockedByNebula(my_spaceship, obj, my_spaceship->getShortRangeRadarRange()))
+                continue;
+            add(*obj);
+        }
+        break;
+    }
+
+    std::stable_sort(snapshot.contacts.begin(), snapshot.contacts.end(), [](const Contact& lhs, const Contact& rhs)
+    {
+        return lhs.layer < rhs.layer || (lhs.layer == rhs.layer && lhs.can_hide_in_nebula && !rhs.can_hide_in_nebula);
+    });
+}
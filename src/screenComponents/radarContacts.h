@@ -0,0 +1,54 @@
+#ifndef RADAR_CONTACTS_H
+#define RADAR_CONTACTS_H
+
+#include "engine.h"
+#include "radarView.h"
+#include "spaceObjects/spaceObject.h"
+#include "revealCoverage.h"
+
+#include <unordered_set>
+
+//Snapshot of the objects visible on the radar of the player ship, per fog of war style.
+//Each snapshot is built at most once per frame and shared by all radar views on this client,
+//instead of every radar view walking all objects and querying the collision manager on its own.
+class RadarContacts : public Updatable
+{
+public:
+    class Contact
+    {
+    public:
+        P<SpaceObject> object;
+        glm::vec2 position;
+        float radius;
+        ERadarLayer layer;
+        bool can_hide_in_nebula;
+    };
+
+    virtual void update(float delta) override;
+
+    //Visible contacts sorted in drawing order (by radar layer, objects that can hide in nebulae first within a layer).
+    static const std::vector<Contact>& get(GuiRadarView::EFogOfWarStyle fog_style);
+    //Check if something that is not a SpaceObject (like a pooled effect) at this position is visible with the given fog of war style.
+    //Uses the snapshot of the current frame, so get() has to be called first.
+    static bool isVisible(glm::vec2 position, float radius, GuiRadarView::EFogOfWarStyle fog_style);
+private:
+    class Snapshot
+    {
+    public:
+        uint64_t frame = 0;
+        int32_t ship_id = -1;
+        bool valid = false;
+        std::vector<Contact> contacts;
+        std::unordered_set<SpaceObject*> visible;
+        RevealCoverage coverage;
+    };
+    static constexpr int fog_style_count = 3;
+
+    static P<RadarContacts> instance;
+    static uint64_t frame;
+    static Snapshot snapshots[fog_style_count];
+
+    static void build(Snapshot& snapshot, GuiRadarView::EFogOfWarStyle fog_style);
+};
+
+#endif//RADAR_CONTACTS_H
@@ -4,10 +4,14 @@
 #include "gameGlobalInfo.h"
 #include "spaceObjects/nebula.h"
 #include "spaceObjects/scanProbe.h"
+#include "spaceObjects/explosionEffect.h"
+#include "spaceObjects/electricExplosionEffect.h"
+#include "effectChannel.h"
 #include "playerInfo.h"
 #include "radarView.h"
 #include "missileTubeControls.h"
 #include "targetsContainer.h"
+#include "radarContacts.h"
 
 namespace
 {
@@ -569,112 +573,40 @@ void GuiRadarView::drawObjects(sp::RenderTarget& renderer)
 {
     float scale = std::min(rect.size.x, rect.size.y) / 2.0f / distance;
 
-    std::unordered_set<SpaceObject*> visible_objects;
-    visible_objects.reserve(space_object_list.size());
-    switch(fog_style)
-    {
-    case NoFogOfWar:
-        foreach(SpaceObject, obj, space_object_list)
-        {
-            visible_objects.emplace(*obj);
-        }
-        break;
-    case FriendlysShortRangeFogOfWar:
-        // Reveal objects if they are within short-range radar range (or 5U) of
-        // a friendly ship, station, or scan probe.
-
-        // Continue only if the player's ship exists.
-        if (!my_spaceship)
-        {
-            return;
-        }
-
-        // For each SpaceObject on the map...
-        foreach(SpaceObject, obj, space_object_list)
-        {
-            // If the object can't hide in a nebula, it's considered visible.
-            if (!obj->canHideInNebula())
-            {
-                visible_objects.emplace(*obj);
-            }
-
-            // Consider the object only if it is:
-            // - Any ShipTemplateBasedObject (ship or station)
-            // - A SpaceObject belonging to a friendly faction
-            // - The player's ship
-            // - A scan probe owned by the player's ship
-            // This check is duplicated in RelayScreen::onDraw.
-            P<ShipTemplateBasedObject> stb_obj = obj;
-
-            if (!stb_obj
-                || (!obj->isFriendly(my_spaceship) && obj != my_spaceship))
-            {
-                P<ScanProbe> sp = obj;
-
-                if (!sp || sp->owner_id != my_spaceship->getMultiplayerId())
-                {
-                    continue;
-                }
-            }
-
-            // Set the radius to reveal as getShortRangeRadarRange() if the
-            // object's a ShipTemplateBasedObject. Otherwise, default to 5U.
-            float r = stb_obj ? stb_obj->getShortRangeRadarRange() : 5000.0f;
-
-            // Query for objects within short-range radar/5U of this object.
-            auto position = obj->getPosition();
-            PVector<Collisionable> obj_list = CollisionManager::queryArea(position - glm::vec2(r, r), position + glm::vec2(r, r));
-
-            // For each of those objects, check if it is at least partially
-            // inside the revealed radius. If so, reveal the object on the map.
-            foreach(Collisionable, c_obj, obj_list)
-            {
-                P<SpaceObject> obj2 = c_obj;
-
-                auto r2 = r + obj2->getRadius();
-                if (obj2 && glm::length2(obj->getPosition() - obj2->getPosition()) < r2*r2)
-                {
-                    visible_objects.emplace(*obj2);
-                }
-            }
-        }
-
-        break;
-    case NebulaFogOfWar:
-        foreach(SpaceObject, obj, space_object_list)
-        {
-            if (obj->canHideInNebula() && my_spaceship && Nebula::blockedByNebula(my_spaceship->getPosition(), obj->getPosition(), my_spaceship->getShortRangeRadarRange()))
-                continue;
-            visible_objects.emplace(*obj);
-        }
-        break;
-    }
-
-    std::vector objects_to_draw(std::begin(visible_objects), std::end(visible_objects));
-    std::sort(std::begin(objects_to_draw), std::end(objects_to_draw), [](const auto& lhs, const auto& rhs)
-    {
-        const auto lhsLayer = lhs->getRadarLayer();
-        const auto rhsLayer = rhs->getRadarLayer();
-        return lhsLayer < rhsLayer || (lhsLayer == rhsLayer && lhs->canHideInNebula() && !rhs->canHideInNebula());
-    });
+    // Friendly fog of war shows nothing without a player ship.
+    if (fog_style == FriendlysShortRangeFogOfWar && !my_spaceship)
+        return;
 
-    auto draw_object = [&renderer, this, scale](SpaceObject* obj)
+    glStencilFunc(GL_EQUAL, as_mask(RadarStencil::RadarBounds), as_mask(RadarStencil::RadarBounds));
+    for(const auto& contact : RadarContacts::get(fog_style))
     {
-        auto object_position_on_screen = worldToScreen(obj->getPosition());
-        float r = obj->getRadius() * scale;
+        SpaceObject* obj = *contact.object;
+        if (!obj || obj == *my_spaceship)
+            continue;
+        auto object_position_on_screen = worldToScreen(contact.position);
+        float r = contact.radius * scale;
         sp::Rect object_rect(object_position_on_screen.x - r, object_position_on_screen.y - r, r * 2, r * 2);
-        if (obj != *my_spaceship && rect.overlaps(object_rect))
+        if (rect.overlaps(object_rect))
         {
             obj->drawOnRadar(renderer, object_position_on_screen, scale, view_rotation, long_range);
             if (show_callsigns && obj->getCallSign() != "")
                 renderer.drawText(sp::Rect(object_position_on_screen.x, object_position_on_screen.y - 15, 0, 0), obj->getCallSign(), sp::Alignment::Center, 15, bold_font);
         }
-    };
-
-    glStencilFunc(GL_EQUAL, as_mask(RadarStencil::RadarBounds), as_mask(RadarStencil::RadarBounds));
-    for(SpaceObject* obj : objects_to_draw)
+    }
+    if (!long_range)
     {
-            draw_object(obj);
+        for(const auto& effect : EffectChannel::getLocalEffects())
+        {
+            if (!effect.on_radar)
+                continue;
+            // Effects follow the same fog of war rules as the objects that caused them.
+            if (!RadarContacts::isVisible(effect.position, EffectChannel::effect_radius, fog_style))
+                continue;
+            if (effect.type == EffectChannel::ElectricExplosion)
+                ElectricExplosionEffect::renderOnRadar(renderer, worldToScreen(effect.position), effect.size * scale, effect.lifetime);
+            else
+                ExplosionEffect::renderOnRadar(renderer, worldToScreen(effect.position), effect.size * scale, effect.lifetime);
+        }
     }
 
     if (my_spaceship)
@@ -3,28 +3,97 @@
 #include "playerInfo.h"
 #include "random.h"
 #include "spaceObjects/playerSpaceship.h"
+#include "effectChannel.h"
+
+#include <cmath>
 
 
 RawScannerDataRadarOverlay::RawScannerDataRadarOverlay(GuiRadarView* owner, string id, float distance)
 : GuiElement(owner, id), radar(owner), distance(distance)
 {
     setSize(GuiElement::GuiSizeMax, GuiElement::GuiSizeMax);
+    histogram.resize(point_count);
+    signatures.resize(point_count);
+    // The smoothing filter reads two points past both ends, these are copies of the wrapped around points.
+    for(auto& amplitude : amplitudes)
+        amplitude.resize(point_count + 4);
 }
 
-void RawScannerDataRadarOverlay::onDraw(sp::RenderTarget& renderer)
+// Determine the bins covered by something at offset from us with the given radius, and how strongly it shows up.
+void RawScannerDataRadarOverlay::calculateContribution(Contribution& contribution)
 {
-    if (!my_spaceship)
+    // Initialize angle, distance, and scale variables.
+    float dist = glm::length(contribution.offset);
+    float scale = 1.0;
+
+    // If the object is more than twice as far away as the maximum radar
+    // range, disregard it.
+    if (dist > distance * 2.0f)
+    {
+        contribution.first_bin = 0;
+        contribution.bin_count = 0;
+        contribution.scaled_info = RawRadarSignatureInfo();
+        contribution.tolerance = dist - distance * 2.0f;
         return;
+    }
 
-    auto view_position = radar->getViewPosition();
-    float view_rotation = radar->getViewRotation();
+    // Moving sideways by half a bin's arc shifts the bearing by at most half a bin.
+    contribution.tolerance = dist * float(M_PI) / float(point_count);
 
-    // Cap the number of signature points, which determines the raw data's
-    // resolution.
-    const int point_count = 512;
-    float radius = std::min(rect.size.x, rect.size.y) / 2.0f;
+    // The further away the object is, the less its effect on radar data.
+    if (dist > distance)
+        scale = 1.0f - ((dist - distance) / distance);
+    contribution.scaled_info = contribution.info * scale;
 
-    RawRadarSignatureInfo signatures[point_count];
+    // If we're adjacent to the object ...
+    if (dist <= contribution.radius)
+    {
+        // ... affect all angles of the radar.
+        contribution.first_bin = 0;
+        contribution.bin_count = point_count;
+        return;
+    }
+
+    // Otherwise, measure the affected range of angles by the object's
+    // distance and radius, and convert it to an exact range of bins.
+    const float bins_per_degree = float(point_count) / 360.0f;
+    float a_diff = glm::degrees(asinf(contribution.radius / dist));
+    float a_center = vec2ToAngle(contribution.offset);
+    int first_bin = int(std::floor((a_center - a_diff) * bins_per_degree));
+    int bin_count = int(std::floor(a_diff * 2.0f * bins_per_degree)) + 1;
+    contribution.first_bin = ((first_bin % point_count) + point_count) % point_count;
+    contribution.bin_count = std::min(bin_count, point_count);
+}
+
+void RawScannerDataRadarOverlay::applyContribution(const Contribution& contribution, std::vector<RawRadarSignatureInfo>& target, bool remove)
+{
+    // Split the range where it wraps around, so both parts are plain loops.
+    int end = std::min(contribution.first_bin + contribution.bin_count, point_count);
+    int wrapped = contribution.first_bin + contribution.bin_count - end;
+    if (remove)
+    {
+        for(int n = contribution.first_bin; n < end; n++)
+            target[n] -= contribution.scaled_info;
+        for(int n = 0; n < wrapped; n++)
+            target[n] -= contribution.scaled_info;
+    }else{
+        for(int n = contribution.first_bin; n < end; n++)
+            target[n] += contribution.scaled_info;
+        for(int n = 0; n < wrapped; n++)
+            target[n] += contribution.scaled_info;
+    }
+}
+
+void RawScannerDataRadarOverlay::updateHistogram(glm::vec2 view_position)
+{
+    generation++;
+    bool rebuild = frames_until_rebuild <= 0;
+    if (rebuild)
+    {
+        frames_until_rebuild = histogram_rebuild_interval;
+        std::fill(histogram.begin(), histogram.end(), RawRadarSignatureInfo());
+    }
+    frames_until_rebuild--;
 
     // For each SpaceObject ...
     foreach(SpaceObject, obj, space_object_list)
@@ -33,35 +102,6 @@ void RawScannerDataRadarOverlay::onDraw(sp::RenderTarget& renderer)
         if (obj == my_spaceship)
             continue;
 
-        // Initialize angle, distance, and scale variables.
-        float a_0, a_1;
-        float dist = glm::length(obj->getPosition() - view_position);
-        float scale = 1.0;
-
-        // If the object is more than twice as far away as the maximum radar
-        // range, disregard it.
-        if (dist > distance * 2.0f)
-            continue;
-
-        // The further away the object is, the less its effect on radar data.
-        if (dist > distance)
-            scale = 1.0f - ((dist - distance) / distance);
-
-        // If we're adjacent to the object ...
-        if (dist <= obj->getRadius())
-        {
-            // ... affect all angles of the radar.
-            a_0 = 0.0f;
-            a_1 = 360.0f;
-        }else{
-            // Otherwise, measure the affected range of angles by the object's
-            // distance and radius.
-            float a_diff = glm::degrees(asinf(obj->getRadius() / dist));
-            float a_center = vec2ToAngle(obj->getPosition() - view_position);
-            a_0 = a_center - a_diff;
-            a_1 = a_center + a_diff;
-        }
-
         // Get the object's radar signature.
         // If the object is a SpaceShip, adjust the signature dynamically based
         // on its current state and activity.
@@ -77,19 +117,80 @@ void RawScannerDataRadarOverlay::onDraw(sp::RenderTarget& renderer)
             info = obj->getRadarSignatureInfo();
         }
 
-        // For each interval determined by the level of raw data resolution,
-        // initialize the signatures array.
-        for(float a = a_0; a <= a_1; a += 360.f / float(point_count))
+        glm::vec2 offset = obj->getPosition() - view_position;
+        float radius = obj->getRadius();
+        auto it = contributions.find(*obj);
+        if (it == contributions.end())
+        {
+            Contribution& contribution = contributions[*obj];
+            contribution = {offset, radius, info, 0, 0, {}, 0.0f, generation};
+            calculateContribution(contribution);
+            applyContribution(contribution, histogram, false);
+            continue;
+        }
+
+        // Objects that moved less than their tolerance relative to us keep their contribution,
+        // so the bearing and arc size are only recalculated for objects that can shift in the histogram.
+        Contribution& contribution = it->second;
+        contribution.generation = generation;
+        glm::vec2 moved = offset - contribution.offset;
+        if (!rebuild && glm::dot(moved, moved) < contribution.tolerance * contribution.tolerance && contribution.radius == radius && !(contribution.info != info))
+            continue;
+
+        // Larger movements still often cover the same bins with the same scaled signature, then the histogram is left as is.
+        Contribution update{offset, radius, info, 0, 0, {}, 0.0f, generation};
+        calculateContribution(update);
+        if (!rebuild && contribution.first_bin == update.first_bin && contribution.bin_count == update.bin_count && !(contribution.scaled_info != update.scaled_info))
         {
-            int idx = (int(a / 360.0f * point_count) + point_count * 2) % point_count;
-            signatures[idx] += info * scale;
+            contribution = update;
+            continue;
         }
+        if (!rebuild)
+            applyContribution(contribution, histogram, true);
+        contribution = update;
+        applyContribution(contribution, histogram, false);
+    }
+
+    // Remove the contributions of objects that no longer exist.
+    for(auto it = contributions.begin(); it != contributions.end(); )
+    {
+        if (it->second.generation != generation)
+        {
+            if (!rebuild)
+                applyContribution(it->second, histogram, true);
+            it = contributions.erase(it);
+        }else{
+            ++it;
+        }
+    }
+}
+
+void RawScannerDataRadarOverlay::onDraw(sp::RenderTarget& renderer)
+{
+    if (!my_spaceship)
+        return;
+
+    auto view_position = radar->getViewPosition();
+    float view_rotation = radar->getViewRotation();
+    float radius = std::min(rect.size.x, rect.size.y) / 2.0f;
+
+    updateHistogram(view_position);
+    signatures = histogram;
+
+    // Explosions and other pooled effects also show up on the raw data.
+    // They only live for a few seconds, so they are added every frame instead of cached.
+    for(const auto& effect : EffectChannel::getLocalEffects())
+    {
+        Contribution contribution{effect.position - view_position, EffectChannel::effect_radius, effect.radar_signature, 0, 0, {}, 0.0f, 0};
+        calculateContribution(contribution);
+        applyContribution(contribution, signatures, false);
     }
 
     // Initialize the data's amplitude along each of the three color bands.
-    float amp_r[point_count];
-    float amp_g[point_count];
-    float amp_b[point_count];
+    // The amplitudes are stored with an offset of 2 for the smoothing filter.
+    float* amp_r = amplitudes[0].data() + 2;
+    float* amp_g = amplitudes[1].data() + 2;
+    float* amp_b = amplitudes[2].data() + 2;
 
     // For each data point ...
     for(int n = 0; n < point_count; n++)
@@ -125,53 +226,35 @@ void RawScannerDataRadarOverlay::onDraw(sp::RenderTarget& renderer)
         amp_b[n] = b;
     }
 
-    // Create a vertex array containing each data point.
-    std::vector<glm::vec2> a_r;
-    std::vector<glm::vec2> a_g;
-    std::vector<glm::vec2> a_b;
-
-    // For each data point ...
-    for(int n = 0; n < point_count; n++)
+    auto center = rect.center();
+    const float band_offset[3] = {0.95f, 0.92f, 0.89f};
+    for(int band = 0; band < 3; band++)
     {
-        // ... set a baseline of 0 ...
-        float r = 0.0;
-        float g = 0.0;
-        float b = 0.0;
-
-        // ... then sum the amplitude values ...
-        for(int m = n - 2 + point_count; m <= n + 2 + point_count; m++)
-        {
-            r += amp_r[m % point_count];
-            g += amp_g[m % point_count];
-            b += amp_b[m % point_count];
-        }
+        // Copy the wrapped around points next to both ends, so the filter
+        // below has no branches or modulo, which lets the compiler vectorize it.
+        float* amp = amplitudes[band].data();
+        amp[0] = amp[point_count];
+        amp[1] = amp[point_count + 1];
+        amp[point_count + 2] = amp[2];
+        amp[point_count + 3] = amp[3];
 
-        // ... divide them by 5 ...
-        r /= 5;
-        g /= 5;
-        b /= 5;
+        // Average each data point with its 2 neighbours on both sides.
+        float smoothed[point_count];
+        for(int n = 0; n < point_count; n++)
+            smoothed[n] = (amp[n] + amp[n + 1] + amp[n + 2] + amp[n + 3] + amp[n + 4]) * 0.2f;
 
         // ... and add vectors for each point.
-        a_r.push_back(
-            glm::vec2(rect.position.x + rect.size.x / 2.0f, rect.position.y + rect.size.y / 2.0f) +
-            vec2FromAngle(float(n) / float(point_count) * 360.0f - view_rotation) * (radius * (0.95f - r / 500)));
+        auto& points = band_points[band];
+        points.clear();
+        for(int n = 0; n < point_count; n++)
+            points.push_back(center + vec2FromAngle(float(n) / float(point_count) * 360.0f - view_rotation) * (radius * (band_offset[band] - smoothed[n] / 500)));
 
-        a_g.push_back(
-            glm::vec2(rect.position.x + rect.size.x / 2.0f, rect.position.y + rect.size.y / 2.0f) +
-            vec2FromAngle(float(n) / float(point_count) * 360.0f - view_rotation) * (radius * (0.92f - g / 500)));
-
-        a_b.push_back(
-            glm::vec2(rect.position.x + rect.size.x / 2.0f, rect.position.y + rect.size.y / 2.0f) +
-            vec2FromAngle(float(n) / float(point_count) * 360.0f - view_rotation) * (radius * (0.89f - b / 500)));
+        // Set a zero value at the "end" of the data point array.
+        points.push_back(points.front());
     }
 
-    // Set a zero value at the "end" of the data point array.
-    a_r.push_back(a_r.front());
-    a_g.push_back(a_g.front());
-    a_b.push_back(a_b.front());
-
     // Draw each band as a line.
-    renderer.drawLineBlendAdd(a_r, glm::u8vec4(255, 0, 0, 255));
-    renderer.drawLineBlendAdd(a_g, glm::u8vec4(0, 255, 0, 255));
-    renderer.drawLineBlendAdd(a_b, glm::u8vec4(0, 0, 255, 255));
+    renderer.drawLineBlendAdd(band_points[0], glm::u8vec4(255, 0, 0, 255));
+    renderer.drawLineBlendAdd(band_points[1], glm::u8vec4(0, 255, 0, 255));
+    renderer.drawLineBlendAdd(band_points[2], glm::u8vec4(0, 0, 255, 255));
 }
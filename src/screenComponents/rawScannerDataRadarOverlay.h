@@ -2,6 +2,9 @@
 #define RAW_SCANNER_DATA_RADAR_OVERLAY_H
 
 #include "gui/gui2_element.h"
+#include "spaceObjects/spaceObject.h"
+
+#include <unordered_map>
 
 class GuiRadarView;
 
@@ -12,8 +15,44 @@ public:
 
     virtual void onDraw(sp::RenderTarget& target) override;
 private:
+    // Number of signature points, which determines the raw data's resolution.
+    static constexpr int point_count = 512;
+    // The histogram is rebuilt from scratch every this many frames, to drop rounding errors of the incremental updates.
+    static constexpr int histogram_rebuild_interval = 300;
+
+    // Signature an object adds to a range of histogram bins.
+    // The offset, radius and info are the inputs, the bin range and scaled info the result that is cached in the histogram.
+    class Contribution
+    {
+    public:
+        glm::vec2 offset;
+        float radius;
+        RawRadarSignatureInfo info;
+        int first_bin;
+        int bin_count;
+        RawRadarSignatureInfo scaled_info;
+        // How far the offset can move before the contribution needs to be recalculated.
+        float tolerance;
+        uint32_t generation;
+    };
+
     GuiRadarView* radar;
     float distance;
+
+    // Angular histogram of the signatures of all objects, only updated for objects whose bin range or scaled signature changed.
+    std::vector<RawRadarSignatureInfo> histogram;
+    std::unordered_map<SpaceObject*, Contribution> contributions;
+    uint32_t generation = 0;
+    int frames_until_rebuild = 0;
+
+    // Buffers reused between frames.
+    std::vector<RawRadarSignatureInfo> signatures;
+    std::vector<float> amplitudes[3];
+    std::vector<glm::vec2> band_points[3];
+
+    void calculateContribution(Contribution& contribution);
+    void applyContribution(const Contribution& contribution, std::vector<RawRadarSignatureInfo>& target, bool remove);
+    void updateHistogram(glm::vec2 view_position);
 };
 
 #endif//RAW_SCANNER_DATA_RADAR_OVERLAY_H
@@ -0,0 +1,114 @@
+#include "revealCoverage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtx/norm.hpp>
+
+void RevealCoverage::begin()
+{
+    generation++;
+}
+
+void RevealCoverage::setRevealer(int32_t id, glm::vec2 position, float range)
+{
+    glm::ivec2 min_cell = toCell(position - glm::vec2(range, range));
+    glm::ivec2 max_cell = toCell(position + glm::vec2(range, range));
+    auto it = revealers.find(id);
+    if (it == revealers.end())
+    {
+        Revealer& revealer = revealers[id];
+        revealer = {position, range, min_cell, max_cell, generation};
+        addToCells(id, revealer);
+        return;
+    }
+    Revealer& revealer = it->second;
+    if (revealer.min_cell != min_cell || revealer.max_cell != max_cell)
+    {
+        removeFromCells(id, revealer);
+        revealer.min_cell = min_cell;
+        revealer.max_cell = max_cell;
+        addToCells(id, revealer);
+    }
+    revealer.position = position;
+    revealer.range = range;
+    revealer.generation = generation;
+}
+
+void RevealCoverage::end()
+{
+    for(auto it = revealers.begin(); it != revealers.end(); )
+    {
+        if (it->second.generation != generation)
+        {
+            removeFromCells(it->first, it->second);
+            it = revealers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void RevealCoverage::clear()
+{
+    revealers.clear();
+    cells.clear();
+}
+
+bool RevealCoverage::isRevealed(glm::vec2 position, float radius) const
+{
+    glm::ivec2 min_cell = toCell(position - glm::vec2(radius, radius));
+    glm::ivec2 max_cell = toCell(position + glm::vec2(radius, radius));
+    for(int y=min_cell.y; y<=max_cell.y; y++)
+    {
+        for(int x=min_cell.x; x<=max_cell.x; x++)
+        {
+            auto it = cells.find(cellKey({x, y}));
+            if (it == cells.end())
+                continue;
+            for(int32_t id : it->second)
+            {
+                const Revealer& revealer = revealers.at(id);
+                float r = revealer.range + radius;
+                if (glm::length2(revealer.position - position) < r * r)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+glm::ivec2 RevealCoverage::toCell(glm::vec2 position)
+{
+    return glm::ivec2(int(std::floor(position.x / cell_size)), int(std::floor(position.y / cell_size)));
+}
+
+uint64_t RevealCoverage::cellKey(glm::ivec2 cell)
+{
+    return (uint64_t(uint32_t(cell.x)) << 32) | uint64_t(uint32_t(cell.y));
+}
+
+void RevealCoverage::addToCells(int32_t id, const Revealer& revealer)
+{
+    for(int y=revealer.min_cell.y; y<=revealer.max_cell.y; y++)
+        for(int x=revealer.min_cell.x; x<=revealer.max_cell.x; x++)
+            cells[cellKey({x, y})].push_back(id);
+}
+
+void RevealCoverage::removeFromCells(int32_t id, const Revealer& revealer)
+{
+    for(int y=revealer.min_cell.y; y<=revealer.max_cell.y; y++)
+    {
+        for(int x=revealer.min_cell.x; x<=revealer.max_cell.x; x++)
+        {
+            auto it = cells.find(cellKey({x, y}));
+            if (it == cells.end())
+                continue;
+            auto& ids = it->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+            if (ids.empty())
+                cells.erase(it);
+        }
+    }
+}
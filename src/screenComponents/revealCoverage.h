@@ -0,0 +1,47 @@
+#ifndef REVEAL_COVERAGE_H
+#define REVEAL_COVERAGE_H
+
+#include <glm/vec2.hpp>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+//Union of the sensor circles of friendly objects, used for the short range fog of war.
+//Revealers are stored in a coarse grid, each cell lists the revealers whose circle overlaps it.
+//A revealer is only moved in the grid when it enters other cells, so the grid is updated incrementally as friendlies move.
+//Testing a contact only checks the revealers in the cells it overlaps, instead of querying the collision manager per revealer.
+class RevealCoverage
+{
+public:
+    static constexpr float cell_size = 5000.0f;
+
+    //Update the coverage: call begin(), then setRevealer() for each revealer, then end() to drop revealers that were not set.
+    void begin();
+    void setRevealer(int32_t id, glm::vec2 position, float range);
+    void end();
+    void clear();
+
+    //True when a circle at this position is at least partially inside the range of a revealer.
+    bool isRevealed(glm::vec2 position, float radius) const;
+private:
+    class Revealer
+    {
+    public:
+        glm::vec2 position;
+        float range;
+        glm::ivec2 min_cell;
+        glm::ivec2 max_cell;
+        uint32_t generation;
+    };
+
+    uint32_t generation = 0;
+    std::unordered_map<int32_t, Revealer> revealers;
+    std::unordered_map<uint64_t, std::vector<int32_t>> cells;
+
+    static glm::ivec2 toCell(glm::vec2 position);
+    static uint64_t cellKey(glm::ivec2 cell);
+    void addToCells(int32_t id, const Revealer& revealer);
+    void removeFromCells(int32_t id, const Revealer& revealer);
+};
+
+#endif//REVEAL_COVERAGE_H
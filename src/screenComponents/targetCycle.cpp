@@ -0,0 +1,65 @@
+#include "targetCycle.h"
+#include "playerInfo.h"
+#include "spaceObjects/playerSpaceship.h"
+
+#include <algorithm>
+
+std::vector<TargetCycle::Entry> TargetCycle::ring;
+
+// Bearing in degrees clockwise from the top of the radar.
+static float bearingTo(glm::vec2 from, glm::vec2 to)
+{
+    float bearing = vec2ToAngle(to - from) + 90.0f;
+    while(bearing < 0.0f)
+        bearing += 360.0f;
+    while(bearing >= 360.0f)
+        bearing -= 360.0f;
+    return bearing;
+}
+
+void TargetCycle::update(float range)
+{
+    glm::vec2 position = my_spaceship->getPosition();
+    ring.clear();
+    foreach(SpaceObject, obj, space_object_list)
+    {
+        if (obj == my_spaceship)
+            continue;
+        if (glm::length(obj->getPosition() - position) >= range)
+            continue;
+        ring.push_back({obj, obj->getMultiplayerId(), bearingTo(position, obj->getPosition())});
+    }
+    std::sort(ring.begin(), ring.end());
+}
+
+P<SpaceObject> TargetCycle::next(P<SpaceObject> current, float range, filter_func_t filter)
+{
+    if (!my_spaceship)
+        return nullptr;
+    update(range);
+    if (ring.empty())
+        return nullptr;
+
+    Entry start;
+    if (current && current != my_spaceship)
+        start = {current, current->getMultiplayerId(), bearingTo(my_spaceship->getPosition(), current->getPosition())};
+    else
+        start = {nullptr, -1, bearingTo(my_spaceship->getPosition(), my_spaceship->getPosition() + vec2FromAngle(my_spaceship->getRotation()))};
+    size_t index = std::upper_bound(ring.begin(), ring.end(), start) - ring.begin();
+
+    P<SpaceObject> result;
+    for(size_t n=0; n<ring.size(); n++)
+    {
+        Entry& e = ring[(index + n) % ring.size()];
+        if (e.object == current)
+            continue;
+        if (filter(e.object))
+        {
+            result = e.object;
+            break;
+        }
+    }
+    // Do not keep the objects referenced until the next use, only the storage is reused.
+    ring.clear();
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef TARGET_CYCLE_H
+#define TARGET_CYCLE_H
+
+#include "engine.h"
+#include "spaceObjects/spaceObject.h"
+
+#include <functional>
+
+//Ring of contacts around the player ship ordered by bearing, shared by the "next target" hotkeys of all screens.
+//Cycling walks the ring clockwise from the current target, so the order is predictable for the crew.
+//The ring is built on each use from the objects within the queried range, only its storage is kept between uses.
+class TargetCycle
+{
+public:
+    typedef std::function<bool(P<SpaceObject>)> filter_func_t;
+
+    //Find the next object clockwise from the current target (or from the ship heading when there is none),
+    //within the range of the player ship and accepted by the filter. Returns nullptr when there is no other candidate.
+    static P<SpaceObject> next(P<SpaceObject> current, float range, filter_func_t filter);
+private:
+    class Entry
+    {
+    public:
+        P<SpaceObject> object;
+        int32_t id;
+        float bearing;
+
+        bool operator<(const Entry& other) const { return bearing < other.bearing || (bearing == other.bearing && id < other.id); }
+    };
+
+    static std::vector<Entry> ring;
+
+    static void update(float range);
+};
+
+#endif//TARGET_CYCLE_H
@@ -10,6 +10,7 @@
 #include "random.h"
 #include "preferenceManager.h"
 #include "particleEffect.h"
+#include "effectChannel.h"
 #include "glObjects.h"
 #include "shaderRegistry.h"
 
@@ -270,6 +271,22 @@ void GuiViewport3D::onDraw(sp::RenderTarget& renderer)
             render_lists.emplace_back();
         render_lists[render_list_index].emplace_back(*obj, depth);
     }
+    // Pooled effects are no SpaceObjects, sort them into render lists of their own with the same depth ranges.
+    std::vector<std::vector<const EffectChannel::LocalEffect*>> effect_render_lists;
+    for(const auto& effect : EffectChannel::getLocalEffects())
+    {
+        float depth = glm::dot(viewVector, effect.position - glm::vec2(camera_position.x, camera_position.y));
+        if (depth + EffectChannel::effect_radius < depth_cutoff_back)
+            continue;
+        if (depth - EffectChannel::effect_radius > depth_cutoff_front)
+            continue;
+        int render_list_index = std::max(0, int((depth + EffectChannel::effect_radius) / 25000));
+        while(render_list_index >= int(effect_render_lists.size()))
+            effect_render_lists.emplace_back();
+        effect_render_lists[render_list_index].push_back(&effect);
+    }
+    if (effect_render_lists.size() > render_lists.size())
+        render_lists.resize(effect_render_lists.size());
 
     // Update view matrix in shaders.
     ShaderRegistry::updateProjectionView({}, view_matrix);
@@ -300,6 +317,8 @@ void GuiViewport3D::onDraw(sp::RenderTarget& renderer)
             SpaceObject* obj = info.object;
             obj->draw3DTransparent();
         }
+        if (n < int(effect_render_lists.size()))
+            EffectChannel::render(effect_render_lists[n]);
     }
     ParticleEngine::render(projection_matrix, view_matrix);
 
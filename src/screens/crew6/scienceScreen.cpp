@@ -10,6 +10,7 @@
 #include "screenComponents/radarView.h"
 #include "screenComponents/rawScannerDataRadarOverlay.h"
 #include "screenComponents/scanTargetButton.h"
+#include "screenComponents/targetCycle.h"
 #include "screenComponents/frequencyCurve.h"
 #include "screenComponents/scanningDialog.h"
 #include "screenComponents/databaseView.h"
@@ -257,7 +258,7 @@ void ScienceScreen::onDraw(sp::RenderTarget& renderer)
         if (targets.get() && glm::length2(probe->getPosition() - targets.get()->getPosition()) > 5000.0f * 5000.0f)
             targets.clear();
     }else{
-        if (targets.get() && Nebula::blockedByNebula(my_spaceship->getPosition(), targets.get()->getPosition(), my_spaceship->getShortRangeRadarRange()))
+        if (targets.get() && Nebula::blockedByNebula(my_spaceship, targets.get(), my_spaceship->getShortRangeRadarRange()))
             targets.clear();
     }
 
@@ -492,47 +493,16 @@ void ScienceScreen::onUpdate()
         if (keys.science_select_next_scannable.getDown() &&
             my_spaceship->scanning_delay == 0.0f)
         {
-            bool current_found = false;
-            for (P<SpaceObject> obj : space_object_list)
+            // Cycle clockwise through scannable objects in radar range that
+            // are not hidden by a nebula.
+            P<SpaceObject> next = TargetCycle::next(targets.get(), science_radar->getDistance(), [](P<SpaceObject> obj)
             {
-                // If this object is the current object, flag and skip it.
-                if (obj == targets.get())
-                {
-                    current_found = true;
-                    continue;
-                }
-
-                // If this object is my ship or not visible due to a Nebula,
-                // skip it.
-                if (obj == my_spaceship ||
-                    Nebula::blockedByNebula(my_spaceship->getPosition(), obj->getPosition(), my_spaceship->getShortRangeRadarRange()))
-                    continue;
-
-                // If this is a scannable object and the currently selected
-                // object, and it remains in radar range, continue to set it.
-                if (current_found &&
-                    glm::length(obj->getPosition() - my_spaceship->getPosition()) < science_radar->getDistance() &&
-                    obj->canBeScannedBy(my_spaceship))
-                {
-                    targets.set(obj);
-                    return;
-                }
-            }
-
-            // Advance to the next object.
-            for (P<SpaceObject> obj : space_object_list)
+                return !Nebula::blockedByNebula(my_spaceship, obj, my_spaceship->getShortRangeRadarRange()) && obj->canBeScannedBy(my_spaceship);
+            });
+            if (next)
             {
-                if (obj == targets.get() ||
-                    obj == my_spaceship ||
-                    Nebula::blockedByNebula(my_spaceship->getPosition(), obj->getPosition(), my_spaceship->getShortRangeRadarRange()))
-                    continue;
-
-                if (glm::length(obj->getPosition() - my_spaceship->getPosition()) < science_radar->getDistance() &&
-                    obj->canBeScannedBy(my_spaceship))
-                {
-                    targets.set(obj);
-                    return;
-                }
+                targets.set(next);
+                return;
             }
         }
     }
@@ -239,12 +239,13 @@ void ShipTemplate::setType(TemplateType type)
 
 void ShipTemplate::setName(string name)
 {
-    if (templateMap.find(name) != templateMap.end())
+    P<ShipTemplate>& entry = templateMap[name];
+    if (entry)
     {
         LOG(ERROR) << "Duplicate ship template definition: " << name;
     }
 
-    templateMap[name] = this;
+    entry = this;
     if (name.startswith("Player "))
         name = name.substr(7);
     this->name = name;
@@ -339,12 +340,13 @@ void ShipTemplate::setShields(const std::vector<float>& values)
 
 P<ShipTemplate> ShipTemplate::getTemplate(string name)
 {
-    if (templateMap.find(name) == templateMap.end())
+    auto it = templateMap.find(name);
+    if (it == templateMap.end())
     {
         LOG(ERROR) << "Failed to find ship template: " << name;
         return nullptr;
     }
-    return templateMap[name];
+    return it->second;
 }
 
 std::vector<string> ShipTemplate::getAllTemplateNames()
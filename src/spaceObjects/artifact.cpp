@@ -1,6 +1,6 @@
 #include <graphics/opengl.h>
 #include "artifact.h"
-#include "explosionEffect.h"
+#include "effectChannel.h"
 #include "playerSpaceship.h"
 #include "main.h"
 #include "random.h"
@@ -154,9 +154,7 @@ void Artifact::setModel(string model_name)
 
 void Artifact::explode()
 {
-    P<ExplosionEffect> e = new ExplosionEffect();
-    e->setSize(getRadius());
-    e->setPosition(getPosition());
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), getRadius(), false);
     destroy();
 }
 
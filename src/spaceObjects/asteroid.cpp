@@ -1,7 +1,7 @@
 #include <graphics/opengl.h>
 #include <glm/gtc/type_ptr.hpp>
 #include "asteroid.h"
-#include "explosionEffect.h"
+#include "effectChannel.h"
 #include "main.h"
 #include "random.h"
 #include "pathPlanner.h"
@@ -92,10 +92,7 @@ void Asteroid::collide(Collisionable* target, float force)
     DamageInfo info(nullptr, DT_Kinetic, getPosition());
     hit_object->takeDamage(35, info);
 
-    P<ExplosionEffect> e = new ExplosionEffect();
-    e->setSize(getRadius());
-    e->setPosition(getPosition());
-    e->setRadarSignatureInfo(0.f, 0.1f, 0.2f);
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), getRadius(), false, RawRadarSignatureInfo(0.f, 0.1f, 0.2f));
     destroy();
 }
 
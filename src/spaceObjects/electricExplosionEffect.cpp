@@ -42,6 +42,11 @@ ElectricExplosionEffect::~ElectricExplosionEffect()
 }
 
 void ElectricExplosionEffect::draw3DTransparent()
+{
+    render(getModelMatrix(), size, lifetime, particleDirections, particlesBuffers);
+}
+
+void ElectricExplosionEffect::render(const glm::mat4& model_matrix, float size, float lifetime, const glm::vec3* particle_directions, gl::Buffers<2>& particles_buffers)
 {
     float f = (1.0f - (lifetime / maxLifetime));
     float scale;
@@ -54,7 +59,6 @@ void ElectricExplosionEffect::draw3DTransparent()
         alpha = Tween<float>::easeInQuad(f, 0.2f, 1.f, 0.5f, 0.0f);
     }
 
-    auto model_matrix = getModelMatrix();
     auto explosion_matrix = glm::scale(model_matrix, glm::vec3(scale * size));
     ShaderRegistry::ScopedShader shader(ShaderRegistry::Shaders::Basic);
 
@@ -93,11 +97,11 @@ void ElectricExplosionEffect::draw3DTransparent()
 
     glUniform4f(shader.get().uniform(ShaderRegistry::Uniforms::Color), r, g, b, size / 32.0f);
 
-    if (!particlesBuffers[0])
-        initializeParticles();
+    if (!particles_buffers[0])
+        initializeParticles(particles_buffers);
 
-    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particlesBuffers[0]);
-    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particlesBuffers[1]);
+    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particles_buffers[0]);
+    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particles_buffers[1]);
     
 
     // Set up attribs
@@ -113,7 +117,7 @@ void ElectricExplosionEffect::draw3DTransparent()
         // setup quads
         for (auto p = 0U; p < active_quads; ++p)
         {
-            glm::vec3 v = particleDirections[n + p] * scale * size;
+            glm::vec3 v = particle_directions[n + p] * scale * size;
             vertices[4 * p + 0] = v;
             vertices[4 * p + 1] = v;
             vertices[4 * p + 2] = v;
@@ -135,7 +139,12 @@ void ElectricExplosionEffect::drawOnRadar(sp::RenderTarget& renderer, glm::vec2
     if (long_range)
         return;
 
-    renderer.fillCircle(position, size * scale, glm::u8vec4(0, 0, 255, 64 * (lifetime / maxLifetime)));
+    renderOnRadar(renderer, position, size * scale, lifetime);
+}
+
+void ElectricExplosionEffect::renderOnRadar(sp::RenderTarget& renderer, glm::vec2 position, float radius, float lifetime)
+{
+    renderer.fillCircle(position, radius, glm::u8vec4(0, 0, 255, 64 * (lifetime / maxLifetime)));
 }
 
 void ElectricExplosionEffect::update(float delta)
@@ -147,16 +156,16 @@ void ElectricExplosionEffect::update(float delta)
         destroy();
 }
 
-void ElectricExplosionEffect::initializeParticles()
+void ElectricExplosionEffect::initializeParticles(gl::Buffers<2>& particles_buffers)
 {
-    particlesBuffers = gl::Buffers<2>();
+    particles_buffers = gl::Buffers<2>();
 
 
     // Each vertex is a position and a texcoords.
     // The two arrays are maintained separately (texcoords are fixed, vertices position change).
     constexpr size_t vertex_size = sizeof(glm::vec3) + sizeof(glm::vec2);
-    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particlesBuffers[0]);
-    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particlesBuffers[1]);
+    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particles_buffers[0]);
+    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particles_buffers[1]);
 
     // VBO
     glBufferData(GL_ARRAY_BUFFER, max_quad_count * 4 * vertex_size, nullptr, GL_STREAM_DRAW);
@@ -6,9 +6,10 @@
 
 class ElectricExplosionEffect : public SpaceObject, public Updatable
 {
+public:
     constexpr static float maxLifetime = 4.f;
     constexpr static int particleCount = 1000;
-
+private:
     float lifetime;
     float size;
     glm::vec3 particleDirections[particleCount];
@@ -26,8 +27,12 @@ public:
 
     void setSize(float size) { this->size = size; }
     void setOnRadar(bool on_radar) { this->on_radar = on_radar; }
+
+    //Rendering shared with the pooled effects of the EffectChannel, which are not SpaceObjects.
+    static void render(const glm::mat4& model_matrix, float size, float lifetime, const glm::vec3* particle_directions, gl::Buffers<2>& particles_buffers);
+    static void renderOnRadar(sp::RenderTarget& renderer, glm::vec2 position, float radius, float lifetime);
 private:
-    void initializeParticles();
+    static void initializeParticles(gl::Buffers<2>& particles_buffers);
 };
 
 #endif//ELECTRIC_EXPLOSION_EFFECT_H
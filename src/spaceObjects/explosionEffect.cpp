@@ -40,6 +40,11 @@ ExplosionEffect::~ExplosionEffect()
 }
 
 void ExplosionEffect::draw3DTransparent()
+{
+    render(getModelMatrix(), size, lifetime, particleDirections, particlesBuffers);
+}
+
+void ExplosionEffect::render(const glm::mat4& model_matrix, float size, float lifetime, const glm::vec3* particle_directions, gl::Buffers<2>& particles_buffers)
 {
     float f = (1.0f - (lifetime / maxLifetime));
     float scale;
@@ -54,7 +59,7 @@ void ExplosionEffect::draw3DTransparent()
     }
 
     std::vector<glm::vec3> vertices(4 * max_quad_count);
-    auto explosion_matrix = glm::scale(getModelMatrix(), glm::vec3(scale * size));
+    auto explosion_matrix = glm::scale(model_matrix, glm::vec3(scale * size));
     ShaderRegistry::ScopedShader shader(ShaderRegistry::Shaders::Basic);
     // Explosion sphere
     {
@@ -71,11 +76,11 @@ void ExplosionEffect::draw3DTransparent()
         m->render(positions.get(), texcoords.get(), normals.get());
     }
 
-    if (!particlesBuffers[0])
-        initializeParticles();
+    if (!particles_buffers[0])
+        initializeParticles(particles_buffers);
 
-    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particlesBuffers[0]);
-    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particlesBuffers[1]);
+    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particles_buffers[0]);
+    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particles_buffers[1]);
 
     // Fire ring
     {
@@ -102,7 +107,7 @@ void ExplosionEffect::draw3DTransparent()
         }
     }
     shader = ShaderRegistry::ScopedShader(ShaderRegistry::Shaders::Billboard);
-    glUniformMatrix4fv(shader.get().uniform(ShaderRegistry::Uniforms::Model), 1, GL_FALSE, glm::value_ptr(getModelMatrix()));
+    glUniformMatrix4fv(shader.get().uniform(ShaderRegistry::Uniforms::Model), 1, GL_FALSE, glm::value_ptr(model_matrix));
 
     gl::ScopedVertexAttribArray positions(shader.get().attribute(ShaderRegistry::Attributes::Position));
     gl::ScopedVertexAttribArray texcoords(shader.get().attribute(ShaderRegistry::Attributes::Texcoords));
@@ -126,7 +131,7 @@ void ExplosionEffect::draw3DTransparent()
         // setup quads
         for (auto p = 0U; p < active_quads; ++p)
         {
-            glm::vec3 v = particleDirections[n + p] * scale * size;
+            glm::vec3 v = particle_directions[n + p] * scale * size;
             vertices[4 * p + 0] = v;
             vertices[4 * p + 1] = v;
             vertices[4 * p + 2] = v;
@@ -147,7 +152,12 @@ void ExplosionEffect::drawOnRadar(sp::RenderTarget& renderer, glm::vec2 position
     if (long_range)
         return;
 
-    renderer.fillCircle(position, size * scale, glm::u8vec4(255, 0, 0, 64 * (lifetime / maxLifetime)));
+    renderOnRadar(renderer, position, size * scale, lifetime);
+}
+
+void ExplosionEffect::renderOnRadar(sp::RenderTarget& renderer, glm::vec2 position, float radius, float lifetime)
+{
+    renderer.fillCircle(position, radius, glm::u8vec4(255, 0, 0, 64 * (lifetime / maxLifetime)));
 }
 
 void ExplosionEffect::update(float delta)
@@ -159,16 +169,16 @@ void ExplosionEffect::update(float delta)
         destroy();
 }
 
-void ExplosionEffect::initializeParticles()
+void ExplosionEffect::initializeParticles(gl::Buffers<2>& particles_buffers)
 {
-    particlesBuffers = gl::Buffers<2>();
+    particles_buffers = gl::Buffers<2>();
 
 
     // Each vertex is a position and a texcoords.
     // The two arrays are maintained separately (texcoords are fixed, vertices position change).
     constexpr size_t vertex_size = sizeof(glm::vec3) + sizeof(glm::vec2);
-    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particlesBuffers[0]);
-    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particlesBuffers[1]);
+    gl::ScopedBufferBinding vbo(GL_ARRAY_BUFFER, particles_buffers[0]);
+    gl::ScopedBufferBinding ebo(GL_ELEMENT_ARRAY_BUFFER, particles_buffers[1]);
 
     // VBO
     glBufferData(GL_ARRAY_BUFFER, max_quad_count * 4 * vertex_size, nullptr, GL_STREAM_DRAW);
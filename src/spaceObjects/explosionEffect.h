@@ -6,9 +6,10 @@
 
 class ExplosionEffect : public SpaceObject, public Updatable
 {
+public:
     constexpr static float maxLifetime = 2.f;
     constexpr static int particleCount = 1000;
-
+private:
     float lifetime;
     float size;
     string explosion_sound;
@@ -28,8 +29,12 @@ public:
     void setSize(float size) { this->size = size; }
     void setExplosionSound(string sound) { this->explosion_sound = sound; }
     void setOnRadar(bool on_radar) { this->on_radar = on_radar; }
+
+    //Rendering shared with the pooled effects of the EffectChannel, which are not SpaceObjects.
+    static void render(const glm::mat4& model_matrix, float size, float lifetime, const glm::vec3* particle_directions, gl::Buffers<2>& particles_buffers);
+    static void renderOnRadar(sp::RenderTarget& renderer, glm::vec2 position, float radius, float lifetime);
 private:
-    void initializeParticles();
+    static void initializeParticles(gl::Buffers<2>& particles_buffers);
 };
 
 #endif//EXPLOSION_EFFECT_H
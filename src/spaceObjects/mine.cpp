@@ -2,7 +2,7 @@
 #include "mine.h"
 #include "playerInfo.h"
 #include "particleEffect.h"
-#include "explosionEffect.h"
+#include "effectChannel.h"
 #include "pathPlanner.h"
 #include "random.h"
 #include "multiplayer_server.h"
@@ -105,11 +105,7 @@ void Mine::explode()
     DamageInfo info(owner, DT_Kinetic, getPosition());
     SpaceObject::damageArea(getPosition(), blastRange, damageAtEdge, damageAtCenter, info, blastRange / 2.0f);
 
-    P<ExplosionEffect> e = new ExplosionEffect();
-    e->setSize(blastRange);
-    e->setPosition(getPosition());
-    e->setOnRadar(true);
-    e->setRadarSignatureInfo(0.0, 0.0, 0.2);
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), blastRange, true, RawRadarSignatureInfo(0.0, 0.0, 0.2));
 
     if (on_destruction.isSet())
     {
@@ -1,6 +1,6 @@
 #include "EMPMissile.h"
 #include "particleEffect.h"
-#include "spaceObjects/electricExplosionEffect.h"
+#include "effectChannel.h"
 #include "pathPlanner.h"
 
 /// EMP missile
@@ -21,11 +21,7 @@ void EMPMissile::explode()
     DamageInfo info(owner, DT_EMP, getPosition());
     SpaceObject::damageArea(getPosition(), category_modifier * blast_range, category_modifier * damage_at_edge, category_modifier * damage_at_center, info, getRadius());
 
-    P<ElectricExplosionEffect> e = new ElectricExplosionEffect();
-    e->setSize(category_modifier * blast_range);
-    e->setPosition(getPosition());
-    e->setOnRadar(true);
-    e->setRadarSignatureInfo(0.0, 1.0, 0.0);
+    EffectChannel::spawn(EffectChannel::ElectricExplosion, getPosition(), category_modifier * blast_range, true, RawRadarSignatureInfo(0.0, 1.0, 0.0));
 }
 
 
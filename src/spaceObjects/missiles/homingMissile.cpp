@@ -1,6 +1,6 @@
 #include "homingMissile.h"
 #include "particleEffect.h"
-#include "spaceObjects/explosionEffect.h"
+#include "effectChannel.h"
 
 /// Homing missile
 REGISTER_SCRIPT_SUBCLASS(HomingMissile, MissileWeapon)
@@ -19,9 +19,5 @@ void HomingMissile::hitObject(P<SpaceObject> object)
 {
     DamageInfo info(owner, DT_Kinetic, getPosition());
     object->takeDamage(category_modifier * 35, info);
-    P<ExplosionEffect> e = new ExplosionEffect();
-    e->setSize(category_modifier * 30);
-    e->setPosition(getPosition());
-    e->setOnRadar(true);
-    e->setRadarSignatureInfo(0.0, 0.0, 0.5);
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), category_modifier * 30, true, RawRadarSignatureInfo(0.0, 0.0, 0.5));
 }
@@ -1,6 +1,6 @@
 #include "hvli.h"
 #include "particleEffect.h"
-#include "spaceObjects/explosionEffect.h"
+#include "effectChannel.h"
 
 /// HVLI missile
 REGISTER_SCRIPT_SUBCLASS(HVLI, MissileWeapon)
@@ -23,9 +23,6 @@ void HVLI::hitObject(P<SpaceObject> object)
         object->takeDamage(category_modifier * 6, info);
     else
         object->takeDamage(category_modifier * 6 * (alive_for / 2.0f), info);
-    P<ExplosionEffect> e = new ExplosionEffect();
-    e->setSize(category_modifier * 20);
-    e->setPosition(getPosition());
-    e->setOnRadar(true);
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), category_modifier * 20, true);
     setRadarSignatureInfo(0.0, 0.0, 0.1);
 }
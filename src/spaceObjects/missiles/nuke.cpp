@@ -1,6 +1,6 @@
 #include "nuke.h"
 #include "particleEffect.h"
-#include "spaceObjects/explosionEffect.h"
+#include "effectChannel.h"
 #include "pathPlanner.h"
 
 /// Nuke missile
@@ -22,11 +22,7 @@ void Nuke::explode()
     DamageInfo info(owner, DT_Kinetic, getPosition());
     SpaceObject::damageArea(getPosition(), category_modifier * blast_range, category_modifier * damage_at_edge, category_modifier * damage_at_center, info, getRadius());
 
-    P<ExplosionEffect> e = new ExplosionEffect();
-    e->setSize(category_modifier * blast_range);
-    e->setPosition(getPosition());
-    e->setOnRadar(true);
-    e->setExplosionSound("sfx/nuke_explosion.wav");
+    EffectChannel::spawn(EffectChannel::NukeExplosion, getPosition(), category_modifier * blast_range, true);
     setRadarSignatureInfo(0.0, 0.7, 1.0);
 }
 
@@ -27,6 +27,20 @@ REGISTER_SCRIPT_SUBCLASS(Nebula, SpaceObject)
 }
 
 PVector<Nebula> Nebula::nebula_list;
+P<CircleIndex> Nebula::nebula_index;
+std::unordered_map<uint64_t, Nebula::VisibilityCacheEntry> Nebula::visibility_cache;
+unsigned int Nebula::visibility_cache_hits;
+unsigned int Nebula::visibility_cache_misses;
+
+// Size of the cells that objects need to move out of before their cached visibility is recalculated.
+static constexpr float visibility_cache_cell_size = 250.0f;
+// The cache is cleared when it grows beyond this amount of entries, which prevents pairs of destroyed objects from piling up.
+static constexpr size_t visibility_cache_max_size = 65536;
+
+static float nebulaRadius(SpaceObject* obj)
+{
+    return obj->getRadius();
+}
 
 REGISTER_MULTIPLAYER_CLASS(Nebula, "Nebula")
 Nebula::Nebula()
@@ -51,6 +65,7 @@ Nebula::Nebula()
     }
 
     nebula_list.push_back(this);
+    getIndex()->add(this);
 }
 
 void Nebula::draw3DTransparent()
@@ -109,12 +124,7 @@ void Nebula::drawOnGMRadar(sp::RenderTarget& renderer, glm::vec2 position, float
 
 bool Nebula::inNebula(glm::vec2 position)
 {
-    foreach(Nebula, n, nebula_list)
-    {
-        if (glm::length2(n->getPosition() - position) < n->getRadius() * n->getRadius())
-            return true;
-    }
-    return false;
+    return getIndex()->anyContains(position);
 }
 
 bool Nebula::blockedByNebula(glm::vec2 start, glm::vec2 end, float radar_short_range)
@@ -124,21 +134,34 @@ bool Nebula::blockedByNebula(glm::vec2 start, glm::vec2 end, float radar_short_r
     if (startEndLength < radar_short_range)
         return false;
 
-    foreach(Nebula, n, nebula_list)
+    return getIndex()->anyOnSegment(start, end);
+}
+
+bool Nebula::blockedByNebula(P<SpaceObject> observer, P<SpaceObject> target, float radar_short_range)
+{
+    auto start = observer->getPosition();
+    auto end = target->getPosition();
+    if (glm::length2(end - start) < radar_short_range * radar_short_range)
+        return false;
+
+    uint64_t key = (uint64_t(observer->getMultiplayerId()) << 32) | uint64_t(target->getMultiplayerId());
+    glm::ivec2 observer_cell = glm::ivec2(glm::floor(start / visibility_cache_cell_size));
+    glm::ivec2 target_cell = glm::ivec2(glm::floor(end / visibility_cache_cell_size));
+    uint32_t generation = getIndex()->getGeneration();
+
+    auto it = visibility_cache.find(key);
+    if (it != visibility_cache.end() && it->second.observer_cell == observer_cell && it->second.target_cell == target_cell && it->second.generation == generation)
     {
-        //Calculate point q, which is a point on the line start-end that is closest to n->getPosition
-        float f = glm::dot(startEndDiff, n->getPosition() - start) / startEndLength;
-        if (f < 0.0f)
-            f = 0.0f;
-        if (f > startEndLength)
-            f = startEndLength;
-        auto q = start + startEndDiff / startEndLength * f;
-        if (glm::length2(q - n->getPosition()) < n->getRadius()*n->getRadius())
-        {
-            return true;
-        }
+        visibility_cache_hits++;
+        return it->second.blocked;
     }
-    return false;
+    visibility_cache_misses++;
+
+    bool blocked = getIndex()->anyOnSegment(start, end);
+    if (visibility_cache.size() >= visibility_cache_max_size)
+        visibility_cache.clear();
+    visibility_cache[key] = {observer_cell, target_cell, generation, blocked};
+    return blocked;
 }
 
 glm::vec2 Nebula::getFirstBlockedPosition(glm::vec2 start, glm::vec2 end)
@@ -176,6 +199,13 @@ PVector<Nebula> Nebula::getNebulas()
     return nebula_list;
 }
 
+P<CircleIndex> Nebula::getIndex()
+{
+    if (!nebula_index)
+        nebula_index = new CircleIndex(5000.0f, nebulaRadius);
+    return nebula_index;
+}
+
 glm::mat4 Nebula::getModelMatrix() const
 {
     return glm::identity<glm::mat4>();
@@ -2,6 +2,8 @@
 #define NEBULA_H
 
 #include "spaceObject.h"
+#include "circleIndex.h"
+#include <unordered_map>
 
 class NebulaCloud
 {
@@ -13,6 +15,19 @@ public:
 class Nebula : public SpaceObject
 {
     static PVector<Nebula> nebula_list;
+    static P<CircleIndex> nebula_index;
+
+    class VisibilityCacheEntry
+    {
+    public:
+        glm::ivec2 observer_cell;
+        glm::ivec2 target_cell;
+        uint32_t generation;
+        bool blocked;
+    };
+    static std::unordered_map<uint64_t, VisibilityCacheEntry> visibility_cache;
+    static unsigned int visibility_cache_hits;
+    static unsigned int visibility_cache_misses;
     static const int cloud_count = 32;
 
     int radar_visual;
@@ -29,12 +44,18 @@ public:
 
     static bool inNebula(glm::vec2 position);
     static bool blockedByNebula(glm::vec2 start, glm::vec2 end, float radar_short_range);
+    // Cached version of blockedByNebula for a pair of objects. The result is reused until either object moves to another
+    // cell of the visibility grid, or the nebulae change.
+    static bool blockedByNebula(P<SpaceObject> observer, P<SpaceObject> target, float radar_short_range);
+    static unsigned int getVisibilityCacheHits() { return visibility_cache_hits; }
+    static unsigned int getVisibilityCacheMisses() { return visibility_cache_misses; }
     static glm::vec2 getFirstBlockedPosition(glm::vec2 start, glm::vec2 end);
     static PVector<Nebula> getNebulas();
 
     virtual string getExportLine() override { return "Nebula():setPosition(" + string(getPosition().x, 0) + ", " + string(getPosition().y, 0) + ")"; }
 
 protected:
+    static P<CircleIndex> getIndex();
     glm::mat4 getModelMatrix() const override;
 };
 
@@ -1,7 +1,7 @@
 #include "playerSpaceship.h"
 #include "gui/colorConfig.h"
 #include "repairCrew.h"
-#include "explosionEffect.h"
+#include "effectChannel.h"
 #include "gameGlobalInfo.h"
 #include "main.h"
 #include "preferenceManager.h"
@@ -11,6 +11,7 @@
 #include "scriptInterface.h"
 
 #include <SDL_assert.h>
+#include <algorithm>
 
 // PlayerSpaceship are ships controlled by a player crew.
 REGISTER_SCRIPT_SUBCLASS(PlayerSpaceship, SpaceShip)
@@ -286,6 +287,9 @@ static const int16_t CMD_SET_MAIN_SCREEN_OVERLAY = 0x0027;
 static const int16_t CMD_HACKING_FINISHED = 0x0028;
 static const int16_t CMD_CUSTOM_FUNCTION = 0x0029;
 static const int16_t CMD_TURN_SPEED = 0x002A;
+static const int16_t CMD_BATCH = 0x002B;
+// Upper limit on the commands in a single batch, a frame never contains more than a few.
+static const uint16_t max_commands_per_batch = 256;
 
 string alertLevelToString(EAlertLevel level)
 {
@@ -415,7 +419,7 @@ PlayerSpaceship::PlayerSpaceship()
         registerMemberReplication(&systems[n].coolant_level);
         registerMemberReplication(&systems[n].coolant_rate_per_second, .5f);
         registerMemberReplication(&systems[n].coolant_request);
-        registerMemberReplication(&systems[n].heat_level, 1.0);
+        quantized_replication.add(this, &systems[n].heat_level, 0.0f, 1.0f, 1.0f);
         registerMemberReplication(&systems[n].heat_rate_per_second, .5f);
         registerMemberReplication(&systems[n].power_factor);
     }
@@ -442,6 +446,10 @@ PlayerSpaceship::~PlayerSpaceship()
 
 void PlayerSpaceship::update(float delta)
 {
+    // Send the commands queued since the previous frame.
+    if (!pending_client_commands.empty())
+        sendClientCommandBatch();
+
     // If we're flashing the screen for hull damage, tick the fade-out.
     if (hull_damage_indicator > 0)
         hull_damage_indicator -= delta;
@@ -609,10 +617,7 @@ void PlayerSpaceship::update(float delta)
         // destroying the ship and damaging a 0.5U radius.
         if (systems[SYS_Reactor].health < -0.9f && systems[SYS_Reactor].heat_level == 1.0f)
         {
-            ExplosionEffect* e = new ExplosionEffect();
-            e->setSize(1000.0f);
-            e->setPosition(getPosition());
-            e->setRadarSignatureInfo(0.0, 0.4, 0.4);
+            EffectChannel::spawn(EffectChannel::Explosion, getPosition(), 1000.0f, false, RawRadarSignatureInfo(0.0, 0.4, 0.4));
 
             DamageInfo info(this, DT_Kinetic, getPosition());
             SpaceObject::damageArea(getPosition(), 500, 30, 60, info, 0.0);
@@ -650,6 +655,7 @@ void PlayerSpaceship::update(float delta)
                 if (scanning_delay < 0)
                 {
                     scanning_target->scannedBy(this);
+                    GameStateLogger::logEvent(GameStateLogger::EEventType::Scanned, this, scanning_target, float(scanning_target->getScannedStateFor(this)));
                     scanning_target = NULL;
                 }
             }
@@ -685,10 +691,7 @@ void PlayerSpaceship::update(float delta)
                 {
                     for(int n = 0; n < 5; n++)
                     {
-                        ExplosionEffect* e = new ExplosionEffect();
-                        e->setSize(self_destruct_size * 0.67f);
-                        e->setPosition(getPosition() + rotateVec2(glm::vec2(0, random(0, self_destruct_size * 0.33f)), random(0, 360)));
-                        e->setRadarSignatureInfo(0.0, 0.6, 0.6);
+                        EffectChannel::spawn(EffectChannel::Explosion, getPosition() + rotateVec2(glm::vec2(0, random(0, self_destruct_size * 0.33f)), random(0, 360)), self_destruct_size * 0.67f, false, RawRadarSignatureInfo(0.0, 0.6, 0.6));
                     }
 
                     DamageInfo info(this, DT_Kinetic, getPosition());
@@ -1223,6 +1226,28 @@ void PlayerSpaceship::onReceiveClientCommand(int32_t client_id, sp::io::DataBuff
 
     switch(command)
     {
+    case CMD_BATCH:
+        {
+            uint16_t count;
+            packet >> count;
+            // Batches are never nested, ignore malformed packets instead of recursing.
+            if (receiving_command_batch || count > max_commands_per_batch)
+                break;
+            receiving_command_batch = true;
+            for(uint16_t n=0; n<count; n++)
+            {
+                // Every command is length prefixed and handled from its own buffer,
+                // so a handler that reads too little or too much cannot shift the commands after it.
+                uint16_t size;
+                packet >> size;
+                std::vector<uint8_t> data(size);
+                packet.readRaw(data.data(), size);
+                sp::io::DataBuffer command_packet(std::move(data));
+                onReceiveClientCommand(client_id, command_packet);
+            }
+            receiving_command_batch = false;
+        }
+        break;
     case CMD_TARGET_ROTATION:
         turnSpeed = 0;
         packet >> target_rotation;
@@ -1324,7 +1349,10 @@ void PlayerSpaceship::onReceiveClientCommand(int32_t client_id, sp::io::DataBuff
         if (scanning_target && scanning_complexity > 0)
         {
             if (scanning_complexity == scanning_target->scanningComplexity(this) && scanning_depth == scanning_target->scanningChannelDepth(this))
+            {
                 scanning_target->scannedBy(this);
+                GameStateLogger::logEvent(GameStateLogger::EEventType::Scanned, this, scanning_target, float(scanning_target->getScannedStateFor(this)));
+            }
             scanning_target = nullptr;
         }
         break;
@@ -1696,40 +1724,82 @@ void PlayerSpaceship::onReceiveClientCommand(int32_t client_id, sp::io::DataBuff
     }
 }
 
+void PlayerSpaceship::queueClientCommand(sp::io::DataBuffer& packet, int32_t coalesce_key)
+{
+    if (game_server)
+    {
+        sendClientCommand(packet);
+        return;
+    }
+    if (coalesce_key != 0)
+    {
+        // Keep the ordering of the latest command, as it may depend on earlier discrete actions.
+        pending_client_commands.erase(std::remove_if(pending_client_commands.begin(), pending_client_commands.end(), [coalesce_key](const PendingClientCommand& pending)
+        {
+            return pending.coalesce_key == coalesce_key;
+        }), pending_client_commands.end());
+    }
+    pending_client_commands.push_back({coalesce_key, std::move(packet)});
+}
+
+void PlayerSpaceship::sendClientCommandBatch()
+{
+    if (pending_client_commands.size() == 1)
+    {
+        sendClientCommand(pending_client_commands[0].packet);
+        pending_client_commands.clear();
+        return;
+    }
+    while(!pending_client_commands.empty())
+    {
+        uint16_t count = uint16_t(std::min(pending_client_commands.size(), size_t(max_commands_per_batch)));
+        sp::io::DataBuffer packet;
+        packet << CMD_BATCH << count;
+        for(uint16_t n=0; n<count; n++)
+        {
+            auto& command_packet = pending_client_commands[n].packet;
+            packet << uint16_t(command_packet.getDataSize());
+            packet.appendRaw(command_packet.getData(), command_packet.getDataSize());
+        }
+        sendClientCommand(packet);
+        pending_client_commands.erase(pending_client_commands.begin(), pending_client_commands.begin() + count);
+    }
+}
+
 // Client-side functions to send a command to the server.
 void PlayerSpaceship::commandTargetRotation(float target)
 {
     sp::io::DataBuffer packet;
     packet << CMD_TARGET_ROTATION << target;
-    sendClientCommand(packet);
+    queueClientCommand(packet, CMD_TARGET_ROTATION);
 }
 
 void PlayerSpaceship::commandTurnSpeed(float turnSpeed)
 {
     sp::io::DataBuffer packet;
     packet << CMD_TURN_SPEED << turnSpeed;
-    sendClientCommand(packet);
+    queueClientCommand(packet, CMD_TARGET_ROTATION);
 }
 
 void PlayerSpaceship::commandImpulse(float target)
 {
     sp::io::DataBuffer packet;
     packet << CMD_IMPULSE << target;
-    sendClientCommand(packet);
+    queueClientCommand(packet, CMD_IMPULSE);
 }
 
 void PlayerSpaceship::commandWarp(int8_t target)
 {
     sp::io::DataBuffer packet;
     packet << CMD_WARP << target;
-    sendClientCommand(packet);
+    queueClientCommand(packet, CMD_WARP);
 }
 
 void PlayerSpaceship::commandJump(float distance)
 {
     sp::io::DataBuffer packet;
     packet << CMD_JUMP << distance;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetTarget(P<SpaceObject> target)
@@ -1739,28 +1809,28 @@ void PlayerSpaceship::commandSetTarget(P<SpaceObject> target)
         packet << CMD_SET_TARGET << target->getMultiplayerId();
     else
         packet << CMD_SET_TARGET << int32_t(-1);
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandLoadTube(int8_t tubeNumber, EMissileWeapons missileType)
 {
     sp::io::DataBuffer packet;
     packet << CMD_LOAD_TUBE << tubeNumber << missileType;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandUnloadTube(int8_t tubeNumber)
 {
     sp::io::DataBuffer packet;
     packet << CMD_UNLOAD_TUBE << tubeNumber;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandFireTube(int8_t tubeNumber, float missile_target_angle)
 {
     sp::io::DataBuffer packet;
     packet << CMD_FIRE_TUBE << tubeNumber << missile_target_angle;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandFireTubeAtTarget(int8_t tubeNumber, P<SpaceObject> target)
@@ -1782,28 +1852,28 @@ void PlayerSpaceship::commandSetShields(bool enabled)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_SHIELDS << enabled;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandMainScreenSetting(EMainScreenSetting mainScreen)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_MAIN_SCREEN_SETTING << mainScreen;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandMainScreenOverlay(EMainScreenOverlay mainScreen)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_MAIN_SCREEN_OVERLAY << mainScreen;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandScan(P<SpaceObject> object)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SCAN_OBJECT << object->getMultiplayerId();
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetSystemPowerRequest(ESystem system, float power_request)
@@ -1811,7 +1881,7 @@ void PlayerSpaceship::commandSetSystemPowerRequest(ESystem system, float power_r
     sp::io::DataBuffer packet;
     systems[system].power_request = power_request;
     packet << CMD_SET_SYSTEM_POWER_REQUEST << system << power_request;
-    sendClientCommand(packet);
+    queueClientCommand(packet, (CMD_SET_SYSTEM_POWER_REQUEST << 8) | system);
 }
 
 void PlayerSpaceship::commandSetSystemCoolantRequest(ESystem system, float coolant_request)
@@ -1819,7 +1889,7 @@ void PlayerSpaceship::commandSetSystemCoolantRequest(ESystem system, float coola
     sp::io::DataBuffer packet;
     systems[system].coolant_request = coolant_request;
     packet << CMD_SET_SYSTEM_COOLANT_REQUEST << system << coolant_request;
-    sendClientCommand(packet);
+    queueClientCommand(packet, (CMD_SET_SYSTEM_COOLANT_REQUEST << 8) | system);
 }
 
 void PlayerSpaceship::commandDock(P<SpaceObject> object)
@@ -1827,21 +1897,21 @@ void PlayerSpaceship::commandDock(P<SpaceObject> object)
     if (!object) return;
     sp::io::DataBuffer packet;
     packet << CMD_DOCK << object->getMultiplayerId();
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandUndock()
 {
     sp::io::DataBuffer packet;
     packet << CMD_UNDOCK;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandAbortDock()
 {
     sp::io::DataBuffer packet;
     packet << CMD_ABORT_DOCK;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandOpenTextComm(P<SpaceObject> obj)
@@ -1849,105 +1919,105 @@ void PlayerSpaceship::commandOpenTextComm(P<SpaceObject> obj)
     if (!obj) return;
     sp::io::DataBuffer packet;
     packet << CMD_OPEN_TEXT_COMM << obj->getMultiplayerId();
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandCloseTextComm()
 {
     sp::io::DataBuffer packet;
     packet << CMD_CLOSE_TEXT_COMM;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandAnswerCommHail(bool awnser)
 {
     sp::io::DataBuffer packet;
     packet << CMD_ANSWER_COMM_HAIL << awnser;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSendComm(uint8_t index)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SEND_TEXT_COMM << index;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSendCommPlayer(string message)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SEND_TEXT_COMM_PLAYER << message;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetAutoRepair(bool enabled)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_AUTO_REPAIR << enabled;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetBeamFrequency(int32_t frequency)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_BEAM_FREQUENCY << frequency;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetBeamSystemTarget(ESystem system)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_BEAM_SYSTEM_TARGET << system;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetShieldFrequency(int32_t frequency)
 {
     sp::io::DataBuffer packet;
     packet << CMD_SET_SHIELD_FREQUENCY << frequency;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandAddWaypoint(glm::vec2 position)
 {
     sp::io::DataBuffer packet;
     packet << CMD_ADD_WAYPOINT << position;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandRemoveWaypoint(int32_t index)
 {
     sp::io::DataBuffer packet;
     packet << CMD_REMOVE_WAYPOINT << index;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandMoveWaypoint(int32_t index, glm::vec2 position)
 {
     sp::io::DataBuffer packet;
     packet << CMD_MOVE_WAYPOINT << index << position;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandActivateSelfDestruct()
 {
     sp::io::DataBuffer packet;
     packet << CMD_ACTIVATE_SELF_DESTRUCT;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandCancelSelfDestruct()
 {
     sp::io::DataBuffer packet;
     packet << CMD_CANCEL_SELF_DESTRUCT;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandConfirmDestructCode(int8_t index, uint32_t code)
 {
     sp::io::DataBuffer packet;
     packet << CMD_CONFIRM_SELF_DESTRUCT << index << code;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandCombatManeuverBoost(float amount)
@@ -1955,7 +2025,7 @@ void PlayerSpaceship::commandCombatManeuverBoost(float amount)
     combat_maneuver_boost_request = amount;
     sp::io::DataBuffer packet;
     packet << CMD_COMBAT_MANEUVER_BOOST << amount;
-    sendClientCommand(packet);
+    queueClientCommand(packet, CMD_COMBAT_MANEUVER_BOOST);
 }
 
 void PlayerSpaceship::commandCombatManeuverStrafe(float amount)
@@ -1963,28 +2033,28 @@ void PlayerSpaceship::commandCombatManeuverStrafe(float amount)
     combat_maneuver_strafe_request = amount;
     sp::io::DataBuffer packet;
     packet << CMD_COMBAT_MANEUVER_STRAFE << amount;
-    sendClientCommand(packet);
+    queueClientCommand(packet, CMD_COMBAT_MANEUVER_STRAFE);
 }
 
 void PlayerSpaceship::commandLaunchProbe(glm::vec2 target_position)
 {
     sp::io::DataBuffer packet;
     packet << CMD_LAUNCH_PROBE << target_position;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandScanDone()
 {
     sp::io::DataBuffer packet;
     packet << CMD_SCAN_DONE;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandScanCancel()
 {
     sp::io::DataBuffer packet;
     packet << CMD_SCAN_CANCEL;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetAlertLevel(EAlertLevel level)
@@ -1992,7 +2062,7 @@ void PlayerSpaceship::commandSetAlertLevel(EAlertLevel level)
     sp::io::DataBuffer packet;
     packet << CMD_SET_ALERT_LEVEL;
     packet << level;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandHackingFinished(P<SpaceObject> target, string target_system)
@@ -2001,7 +2071,7 @@ void PlayerSpaceship::commandHackingFinished(P<SpaceObject> target, string targe
     packet << CMD_HACKING_FINISHED;
     packet << target->getMultiplayerId();
     packet << target_system;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandCustomFunction(string name)
@@ -2009,7 +2079,7 @@ void PlayerSpaceship::commandCustomFunction(string name)
     sp::io::DataBuffer packet;
     packet << CMD_CUSTOM_FUNCTION;
     packet << name;
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::commandSetScienceLink(P<ScanProbe> probe)
@@ -2021,7 +2091,7 @@ void PlayerSpaceship::commandSetScienceLink(P<ScanProbe> probe)
     {
         packet << CMD_SET_SCIENCE_LINK;
         packet << probe->getMultiplayerId();
-        sendClientCommand(packet);
+        queueClientCommand(packet);
     }
     // Otherwise, it's invalid. Warn and do nothing.
     else
@@ -2036,7 +2106,7 @@ void PlayerSpaceship::commandClearScienceLink()
 
     packet << CMD_SET_SCIENCE_LINK;
     packet << int32_t(-1);
-    sendClientCommand(packet);
+    queueClientCommand(packet);
 }
 
 void PlayerSpaceship::onReceiveServerCommand(sp::io::DataBuffer& packet)
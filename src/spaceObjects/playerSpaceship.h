@@ -114,6 +114,21 @@ private:
     std::vector<ShipLogEntry> ships_log;
     float energy_shield_use_per_second = default_energy_shield_use_per_second;
     float energy_warp_per_second = default_energy_warp_per_second;
+
+    // Commands from a client are collected during a frame and sent to the server as a single batch.
+    class PendingClientCommand
+    {
+    public:
+        int32_t coalesce_key;
+        sp::io::DataBuffer packet;
+    };
+    std::vector<PendingClientCommand> pending_client_commands; // Client only
+    bool receiving_command_batch = false; // Server only
+
+    // Queue a command for the next batch. A command with a non-zero coalesce key replaces the queued command with the same key,
+    // so continuous controls only send their latest value. On the server the command is handled directly.
+    void queueClientCommand(sp::io::DataBuffer& packet, int32_t coalesce_key = 0);
+    void sendClientCommandBatch();
 public:
     std::vector<CustomShipFunction> custom_functions;
 
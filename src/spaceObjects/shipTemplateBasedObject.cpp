@@ -1,4 +1,5 @@
 #include "shipTemplateBasedObject.h"
+#include "gameStateLogger.h"
 
 #include "scriptInterface.h"
 
@@ -121,8 +122,11 @@ ShipTemplateBasedObject::ShipTemplateBasedObject(float collision_range, string m
 
     long_range_radar_range = 30000.0f;
     short_range_radar_range = 5000.0f;
+    template_version = 0;
+    resolved_template_version = -1;
 
     registerMemberReplication(&template_name);
+    registerMemberReplication(&template_version);
     registerMemberReplication(&type_name);
     registerMemberReplication(&shield_count);
     for(int n=0; n<max_shield_count; n++)
@@ -225,10 +229,11 @@ void ShipTemplateBasedObject::update(float delta)
 {
     // All ShipTemplateBasedObjects should have a valid template.
     // If this object lacks a template, or has an inconsistent template...
-    if (!ship_template || ship_template->getName() != template_name)
+    if (!ship_template || resolved_template_version != template_version)
     {
         // Attempt to align the object's template to its reported template name.
         ship_template = ShipTemplate::getTemplate(template_name);
+        resolved_template_version = template_version;
 
         // If the template still doesn't exist, destroy the object.
         if (!ship_template)
@@ -283,6 +288,7 @@ bool ShipTemplateBasedObject::hasShield()
 
 void ShipTemplateBasedObject::takeDamage(float damage_amount, DamageInfo info)
 {
+    GameStateLogger::logEvent(GameStateLogger::EEventType::Damage, this, info.instigator, damage_amount);
     if (shield_count > 0 && getShieldsActive())
     {
         float angle = angleDifference(getRotation(), vec2ToAngle(info.location - getPosition()));
@@ -364,6 +370,8 @@ void ShipTemplateBasedObject::setTemplate(string template_name)
     P<ShipTemplate> new_ship_template = ShipTemplate::getTemplate(template_name);
     this->template_name = template_name;
     ship_template = new_ship_template;
+    template_version++;
+    resolved_template_version = template_version;
     type_name = template_name;
 
     hull_strength = hull_max = ship_template->hull;
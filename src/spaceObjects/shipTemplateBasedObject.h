@@ -17,6 +17,9 @@ class ShipTemplateBasedObject : public SpaceObject, public Updatable
 private:
     float long_range_radar_range;
     float short_range_radar_range;
+    //Incremented whenever template_name is set, and replicated with it. So update() only needs to compare integers to see if ship_template is still current.
+    int template_version;
+    int resolved_template_version;
 public:
     string template_name;
     string type_name;
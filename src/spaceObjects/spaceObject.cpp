@@ -279,6 +279,7 @@ PVector<SpaceObject> space_object_list;
 SpaceObject::SpaceObject(float collision_range, string multiplayer_name, float multiplayer_significant_range)
 : Collisionable(collision_range), MultiplayerObject(multiplayer_name)
 {
+    ReplicationProfiler::registerObject(this, multiplayer_name);
     object_radius = collision_range;
     space_object_list.push_back(this);
     faction_id = 0;
@@ -299,11 +300,19 @@ SpaceObject::SpaceObject(float collision_range, string multiplayer_name, float m
     registerMemberReplication(&scanning_complexity_value);
     registerMemberReplication(&scanning_depth_value);
     registerCollisionableReplication(multiplayer_significant_range);
+    if (ReplicationProfiler::isEnabled())
+    {
+        ReplicationProfiler::trackValue<glm::vec2>(this, [this]() { return getPosition(); }, 0.0f, "position");
+        ReplicationProfiler::trackValue<float>(this, [this]() { return getRotation(); }, 0.0f, "rotation");
+        ReplicationProfiler::trackValue<glm::vec2>(this, [this]() { return getVelocity(); }, 0.0f, "velocity");
+        ReplicationProfiler::trackValue<float>(this, [this]() { return getAngularVelocity(); }, 0.0f, "angular_velocity");
+    }
 }
 
 //due to a suspected compiler bug this deconstructor needs to be explicitly defined
 SpaceObject::~SpaceObject()
 {
+    ReplicationProfiler::unregisterObject(this);
 }
 
 void SpaceObject::draw3D()
@@ -321,6 +330,7 @@ void SpaceObject::drawOnGMRadar(sp::RenderTarget& renderer, glm::vec2 position,
 
 void SpaceObject::destroy()
 {
+    GameStateLogger::logEvent(GameStateLogger::EEventType::Destroyed, this);
     on_destroyed.call<void>(P<SpaceObject>(this));
     MultiplayerObject::destroy();
 }
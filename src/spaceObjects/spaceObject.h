@@ -8,6 +8,7 @@
 #include "modelInfo.h"
 #include "factionInfo.h"
 #include "shipTemplate.h"
+#include "replicationProfiler.h"
 #include "graphics/renderTarget.h"
 
 #include <glm/mat4x4.hpp>
@@ -59,6 +60,14 @@ public:
         return *this;
     }
 
+    RawRadarSignatureInfo& operator-=(const RawRadarSignatureInfo& o)
+    {
+        gravity -= o.gravity;
+        electrical -= o.electrical;
+        biological -= o.biological;
+        return *this;
+    }
+
     bool operator!=(const RawRadarSignatureInfo& o)
     {
         return gravity != o.gravity || electrical != o.electrical || biological != o.biological;
@@ -245,6 +254,13 @@ public:
 
     glm::mat4 getModelTransform() const { return getModelMatrix(); }
 
+    //Hides MultiplayerObject::registerMemberReplication, so the ReplicationProfiler can track every replicated member of SpaceObjects.
+    template<typename T> void registerMemberReplication(T* member, float update_delay = 0.0f)
+    {
+        MultiplayerObject::registerMemberReplication(member, update_delay);
+        ReplicationProfiler::trackMember(this, member, update_delay);
+    }
+
 protected:
     virtual glm::mat4 getModelMatrix() const;
     ModelInfo model_info;
@@ -1,4 +1,4 @@
-#include "spaceObjects/explosionEffect.h"
+#include "effectChannel.h"
 #include "spaceObjects/spaceStation.h"
 #include "spaceObjects/spaceship.h"
 #include "spaceObjects/playerSpaceship.h"
@@ -56,10 +56,7 @@ void SpaceStation::applyTemplateValues()
 
 void SpaceStation::destroyedByDamage(DamageInfo& info)
 {
-    ExplosionEffect* e = new ExplosionEffect();
-    e->setSize(getRadius());
-    e->setPosition(getPosition());
-    e->setRadarSignatureInfo(0.0, 0.4, 0.4);
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), getRadius(), false, RawRadarSignatureInfo(0.0, 0.4, 0.4));
 
     if (info.instigator)
     {
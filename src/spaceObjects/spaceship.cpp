@@ -10,7 +10,7 @@
 #include "playerInfo.h"
 #include "spaceObjects/beamEffect.h"
 #include "factionInfo.h"
-#include "spaceObjects/explosionEffect.h"
+#include "effectChannel.h"
 #include "particleEffect.h"
 #include "spaceObjects/warpJammer.h"
 #include "textureManager.h"
@@ -214,10 +214,10 @@ SpaceShip::SpaceShip(string multiplayerClassName, float multiplayer_significant_
     max_energy_level = 1000;
     turnSpeed = 0.0f;
 
-    registerMemberReplication(&target_rotation, 1.5f);
+    quantized_replication.addAngle(this, &target_rotation, 1.5f);
     registerMemberReplication(&turnSpeed, 0.1f);
     registerMemberReplication(&impulse_request, 0.1f);
-    registerMemberReplication(&current_impulse, 0.5f);
+    quantized_replication.add(this, &current_impulse, -1.0f, 1.0f, 0.5f);
     registerMemberReplication(&has_warp_drive);
     registerMemberReplication(&warp_request, 0.1f);
     registerMemberReplication(&current_warp, 0.1f);
@@ -238,7 +238,7 @@ SpaceShip::SpaceShip(string multiplayerClassName, float multiplayer_significant_
     registerMemberReplication(&shield_frequency);
     registerMemberReplication(&docking_state);
     registerMemberReplication(&beam_frequency);
-    registerMemberReplication(&combat_maneuver_charge, 0.5f);
+    quantized_replication.add(this, &combat_maneuver_charge, 0.0f, 1.0f, 0.5f);
     registerMemberReplication(&combat_maneuver_boost_request);
     registerMemberReplication(&combat_maneuver_boost_active, 0.2f);
     registerMemberReplication(&combat_maneuver_strafe_request);
@@ -263,9 +263,9 @@ SpaceShip::SpaceShip(string multiplayerClassName, float multiplayer_significant_
         systems[n].hacked_level = 0.0f;
         systems[n].power_factor = default_system_power_factors[n];
 
-        registerMemberReplication(&systems[n].health, 0.1f);
-        registerMemberReplication(&systems[n].health_max, 0.1f);
-        registerMemberReplication(&systems[n].hacked_level, 0.1f);
+        quantized_replication.add(this, &systems[n].health, -1.0f, 1.0f, 0.1f);
+        quantized_replication.add(this, &systems[n].health_max, -1.0f, 1.0f, 0.1f);
+        quantized_replication.add(this, &systems[n].hacked_level, 0.0f, 1.0f, 0.1f);
     }
 
     for(int n = 0; n < max_beam_weapons; n++)
@@ -621,6 +621,7 @@ void SpaceShip::drawOnGMRadar(sp::RenderTarget& renderer, glm::vec2 position, fl
 void SpaceShip::update(float delta)
 {
     ShipTemplateBasedObject::update(delta);
+    quantized_replication.update();
 
     if (game_server)
     {
@@ -928,6 +929,7 @@ void SpaceShip::collide(Collisionable* other, float force)
         if (dock_object == docking_target)
         {
             docking_state = DS_Docked;
+            GameStateLogger::logEvent(GameStateLogger::EEventType::Docked, this, docking_target);
             docking_offset = rotateVec2(getPosition() - other->getPosition(), -other->getRotation());
             float length = glm::length(docking_offset);
             docking_offset = docking_offset / length * (length + 2.0f);
@@ -1205,10 +1207,7 @@ void SpaceShip::takeHullDamage(float damage_amount, DamageInfo& info)
 
 void SpaceShip::destroyedByDamage(DamageInfo& info)
 {
-    ExplosionEffect* e = new ExplosionEffect();
-    e->setSize(getRadius() * 1.5f);
-    e->setPosition(getPosition());
-    e->setRadarSignatureInfo(0.f, 0.2f, 0.2f);
+    EffectChannel::spawn(EffectChannel::Explosion, getPosition(), getRadius() * 1.5f, false, RawRadarSignatureInfo(0.f, 0.2f, 0.2f));
 
     if (info.instigator)
     {
@@ -10,6 +10,7 @@
 #include "spaceshipParts/beamWeapon.h"
 #include "spaceshipParts/weaponTube.h"
 #include "tween.h"
+#include "quantizedReplication.h"
 
 
 enum EMainScreenSetting
@@ -97,6 +98,8 @@ public:
     float energy_level;
     float max_energy_level;
     ShipSystem systems[SYS_COUNT];
+    // Fixed point replication of float members with a known range, see QuantizedReplication.
+    QuantizedReplication quantized_replication;
     static std::array<float, SYS_COUNT> default_system_power_factors;
     /*!
      *[input] Ship will try to aim to this rotation. (degrees)
@@ -2,6 +2,7 @@
 #include "spaceObjects/spaceship.h"
 #include "spaceObjects/beamEffect.h"
 #include "spaceObjects/spaceObject.h"
+#include "gameStateLogger.h"
 #include "multiplayer_server.h"
 
 #include <SDL_assert.h>
@@ -286,5 +287,6 @@ void BeamWeapon::fire(P<SpaceObject> target, ESystem system_target)
     DamageInfo info(parent, damage_type, hit_location);
     info.frequency = parent->beam_frequency; // Beam weapons now always use frequency of the ship.
     info.system_target = system_target;
+    GameStateLogger::logEvent(GameStateLogger::EEventType::BeamFire, parent, target, damage);
     target->takeDamage(damage, info);
 }
@@ -5,6 +5,7 @@
 #include "spaceObjects/missiles/nuke.h"
 #include "spaceObjects/missiles/hvli.h"
 #include "spaceObjects/spaceship.h"
+#include "gameStateLogger.h"
 #include "multiplayer_server.h"
 #include <SDL_assert.h>
 
@@ -112,11 +113,13 @@ void WeaponTube::fire(float target_angle)
 void WeaponTube::spawnProjectile(float target_angle)
 {
     auto fireLocation = parent->getPosition() + rotateVec2(parent->ship_template->model_data->getTubePosition2D(tube_index), parent->getRotation());
+    P<SpaceObject> projectile;
     switch(type_loaded)
     {
     case MW_Homing:
         {
             P<HomingMissile> missile = new HomingMissile();
+            projectile = missile;
             missile->owner = parent;
             missile->setFactionId(parent->getFactionId());
             missile->target_id = parent->target_id;
@@ -129,6 +132,7 @@ void WeaponTube::spawnProjectile(float target_angle)
     case MW_Nuke:
         {
             P<Nuke> missile = new Nuke();
+            projectile = missile;
             missile->owner = parent;
             missile->setFactionId(parent->getFactionId());
             missile->target_id = parent->target_id;
@@ -141,6 +145,7 @@ void WeaponTube::spawnProjectile(float target_angle)
     case MW_Mine:
         {
             P<Mine> missile = new Mine();
+            projectile = missile;
             missile->owner = parent;
             missile->setFactionId(parent->getFactionId());
             missile->setPosition(fireLocation);
@@ -151,6 +156,7 @@ void WeaponTube::spawnProjectile(float target_angle)
     case MW_HVLI:
         {
             P<HVLI> missile = new HVLI();
+            projectile = missile;
             missile->owner = parent;
             missile->setFactionId(parent->getFactionId());
             missile->setPosition(fireLocation);
@@ -162,6 +168,7 @@ void WeaponTube::spawnProjectile(float target_angle)
     case MW_EMP:
         {
             P<EMPMissile> missile = new EMPMissile();
+            projectile = missile;
             missile->owner = parent;
             missile->setFactionId(parent->getFactionId());
             missile->target_id = parent->target_id;
@@ -174,6 +181,8 @@ void WeaponTube::spawnProjectile(float target_angle)
     default:
         break;
     }
+    if (projectile)
+        GameStateLogger::logEvent(GameStateLogger::EEventType::MissileLaunch, parent, projectile, float(type_loaded));
 }
 
 bool WeaponTube::canLoad(EMissileWeapons type)
@@ -1,7 +1,7 @@
 #include "warpJammer.h"
 #include "playerInfo.h"
 #include "spaceObjects/playerSpaceship.h"
-#include "explosionEffect.h"
+#include "effectChannel.h"
 #include "main.h"
 
 #include "scriptInterface.h"
@@ -21,6 +21,12 @@ REGISTER_SCRIPT_SUBCLASS(WarpJammer, SpaceObject)
 REGISTER_MULTIPLAYER_CLASS(WarpJammer, "WarpJammer");
 
 PVector<WarpJammer> WarpJammer::jammer_list;
+P<CircleIndex> WarpJammer::jammer_index;
+
+static float jammerRange(SpaceObject* obj)
+{
+    return static_cast<WarpJammer*>(obj)->getRange();
+}
 
 WarpJammer::WarpJammer()
 : SpaceObject(100, "WarpJammer")
@@ -29,6 +35,7 @@ WarpJammer::WarpJammer()
     hull = 50;
 
     jammer_list.push_back(this);
+    getIndex()->add(this);
     setRadarSignatureInfo(0.05, 0.5, 0.0);
 
     registerMemberReplication(&range);
@@ -64,10 +71,7 @@ void WarpJammer::takeDamage(float damage_amount, DamageInfo info)
     hull -= damage_amount;
     if (hull <= 0)
     {
-        P<ExplosionEffect> e = new ExplosionEffect();
-        e->setSize(getRadius());
-        e->setPosition(getPosition());
-        e->setRadarSignatureInfo(0.5, 0.5, 0.1);
+        EffectChannel::spawn(EffectChannel::Explosion, getPosition(), getRadius(), false, RawRadarSignatureInfo(0.5, 0.5, 0.1));
 
         if (on_destruction.isSet())
         {
@@ -95,12 +99,7 @@ void WarpJammer::takeDamage(float damage_amount, DamageInfo info)
 
 bool WarpJammer::isWarpJammed(glm::vec2 position)
 {
-    foreach(WarpJammer, wj, jammer_list)
-    {
-        if (glm::length2(wj->getPosition() - position) < wj->range * wj->range)
-            return true;
-    }
-    return false;
+    return getIndex()->anyContains(position);
 }
 
 glm::vec2 WarpJammer::getFirstNoneJammedPosition(glm::vec2 start, glm::vec2 end)
@@ -133,6 +132,13 @@ glm::vec2 WarpJammer::getFirstNoneJammedPosition(glm::vec2 start, glm::vec2 end)
     return first_jammer_q + glm::normalize(start - end) * sqrtf(first_jammer->range * first_jammer->range - d * d);
 }
 
+P<CircleIndex> WarpJammer::getIndex()
+{
+    if (!jammer_index)
+        jammer_index = new CircleIndex(7000.0f, jammerRange);
+    return jammer_index;
+}
+
 void WarpJammer::onTakingDamage(ScriptSimpleCallback callback)
 {
     this->on_taking_damage = callback;
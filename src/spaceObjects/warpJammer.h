@@ -2,10 +2,12 @@
 #define WARP_JAMMER_H
 
 #include "spaceObject.h"
+#include "circleIndex.h"
 
 class WarpJammer : public SpaceObject
 {
     static PVector<WarpJammer> jammer_list;
+    static P<CircleIndex> jammer_index;
 
     float range;
     float hull;
@@ -31,6 +33,8 @@ public:
     void onDestruction(ScriptSimpleCallback callback);
 
     virtual string getExportLine() override;
+private:
+    static P<CircleIndex> getIndex();
 };
 
 #endif//WARP_JAMMER_H